@@ -0,0 +1,57 @@
+#include "benchmark.hpp"
+#include "board/attacks.hpp"
+#include "board/bits.hpp"
+#include <vector>
+
+struct SliderSet {
+  uint64_t rooks;
+  uint64_t bishops;
+  uint64_t occupied;
+};
+
+void bench_attacks() {
+  // middlegame-like sets of a few sliders on a half-full board
+  uint64_t state = 0x9E3779B97F4A7C15;
+  auto next = [&state]() {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+  };
+  std::vector<SliderSet> sets;
+  for (int i = 0; i < 64; i++) {
+    const uint64_t occupied = (next() & next()) | (next() & next());
+    sets.push_back({
+        .rooks = occupied & next() & next() & next(),
+        .bishops = occupied & next() & next() & next(),
+        .occupied = occupied,
+    });
+  }
+
+  run_benchmark("slider attack map (lookups)", 100000, [&]() {
+    for (const SliderSet &set : sets) {
+      uint64_t attacked = 0;
+      for (const int square : bits::SetBits(set.rooks)) {
+        attacked |= attacks::rook(square, set.occupied);
+      }
+      for (const int square : bits::SetBits(set.bishops)) {
+        attacked |= attacks::bishop(square, set.occupied);
+      }
+      do_not_optimize(attacked);
+    }
+  });
+  run_benchmark("slider attack map (Kogge-Stone)", 100000, [&]() {
+    for (const SliderSet &set : sets) {
+      do_not_optimize(
+          attacks::sliders_scalar(set.rooks, set.bishops, set.occupied));
+    }
+  });
+  if (attacks::cpu_supports_avx2()) {
+    run_benchmark("slider attack map (Kogge-Stone AVX2)", 100000, [&]() {
+      for (const SliderSet &set : sets) {
+        do_not_optimize(
+            attacks::sliders_avx2(set.rooks, set.bishops, set.occupied));
+      }
+    });
+  }
+}
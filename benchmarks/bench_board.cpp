@@ -0,0 +1,78 @@
+#include "benchmark.hpp"
+#include "board/board.hpp"
+#include "engine/move_picker.hpp"
+#include "move_list.hpp"
+#include "perft.hpp"
+#include <algorithm>
+
+void bench_board() {
+  std::vector<Board> boards = get_benchmark_positions();
+
+  run_benchmark("get_piece_type (all squares)", 1000000, [&]() {
+    for (const Board &board : boards) {
+      int pieces = 0;
+      for (int pos = 0; pos < 64; pos++) {
+        pieces += board.get_piece_type(pos).value_or(KING);
+      }
+      do_not_optimize(pieces);
+    }
+  });
+
+  run_benchmark("capture ordering (MovePicker)", 1000000, [&]() {
+    for (const Board &board : boards) {
+      MovePicker move_picker(board, std::nullopt);
+      std::optional<Move> move = move_picker.next();
+      while (move.has_value()) {
+        do_not_optimize(move);
+        move = move_picker.next();
+      }
+    }
+  });
+
+  run_benchmark("legal move generation", 1000000, [&]() {
+    for (const Board &board : boards) {
+      do_not_optimize(board.get_legal_moves(ALL));
+    }
+  });
+
+  std::vector<MoveList> legal_moves;
+  for (const Board &board : boards) {
+    legal_moves.push_back(board.get_legal_moves(ALL));
+  }
+  run_benchmark("make/undo (all legal moves)", 100000, [&]() {
+    for (size_t i = 0; i < boards.size(); i++) {
+      for (const Move &move : legal_moves.at(i)) {
+        boards.at(i).make(move);
+        boards.at(i).undo();
+      }
+    }
+  });
+
+  const double make_undo_ns = run_benchmark("perft 3 (make/undo)", 20, [&]() {
+    for (Board &board : boards) {
+      do_not_optimize(perft<MAKE_UNDO>(board, 3));
+    }
+  });
+  const double copy_make_ns = run_benchmark("perft 3 (copy-make)", 20, [&]() {
+    for (Board &board : boards) {
+      do_not_optimize(perft<COPY_MAKE>(board, 3));
+    }
+  });
+  fmt::println("{} is faster by {:.1f}%",
+               make_undo_ns < copy_make_ns ? "make/undo" : "copy-make",
+               100.0 * (std::max(make_undo_ns, copy_make_ns) /
+                            std::min(make_undo_ns, copy_make_ns) -
+                        1));
+
+  Board game = Board::get_starting_position();
+  for (int i = 0; i < 10; i++) {
+    game.make(Move(g1, f3));
+    game.make(Move(g8, f6));
+    game.make(Move(f3, g1));
+    game.make(Move(f6, g8));
+  }
+  run_benchmark("copy board (40 plies played)", 1000000, [&]() {
+    Board copy = game;
+    do_not_optimize(copy);
+  });
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <fmt/core.h>
+#include <string_view>
+#include <vector>
+
+#include "board/board.hpp"
+#include "fen.hpp"
+
+// positions from the opening, middlegame and endgame
+// that the benchmarks are run on
+inline std::vector<Board> get_benchmark_positions() {
+  return {
+      Board::get_starting_position(),
+      fen::get_position("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/"
+                        "R3K2R w KQkq - 0 1"),
+      fen::get_position("r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP3PPP/"
+                        "R2QKB1R w KQ - 0 8"),
+      fen::get_position("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"),
+  };
+}
+
+// keeps the compiler from optimizing away a result that is never used
+template <typename T> inline void do_not_optimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// runs the function the given number of times
+// and prints and returns the average time each run took in nanoseconds
+template <typename Function>
+double run_benchmark(std::string_view name, long iterations,
+                   Function function) {
+  function();
+
+  const auto start_time = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++) {
+    function();
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start_time;
+
+  const double ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  fmt::println("{:<40} {:>12.1f} ns/run", name, ns / iterations);
+  return ns / iterations;
+}
@@ -0,0 +1,8 @@
+#include "bench_attacks.cpp"
+#include "bench_board.cpp"
+
+int main() {
+  bench_attacks();
+  bench_board();
+  return 0;
+}
@@ -1,6 +1,6 @@
 #!/bin/bash
 
-find ./src ./tests -name '*.cpp' \
+find ./src ./tests ./benchmarks -name '*.cpp' \
       -not -path './src/board/bits.cpp' \
       -o -name '*.hpp' \
       -not -path './src/defs.hpp' \
@@ -0,0 +1,301 @@
+#include "attacks.hpp"
+
+#include <array>
+
+#include "bits.hpp"
+#include "masks.hpp"
+
+#if !defined(__BMI2__) && defined(__GNUC__) &&                                 \
+    (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PEXT_RUNTIME_DISPATCH
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define AVX2_TARGET
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define AVX2_RUNTIME_DISPATCH
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace attacks {
+
+SliderSquare rook_squares[64];
+SliderSquare bishop_squares[64];
+bool pext_enabled = false;
+
+// one entry for every subset of the relevant occupancy of every square
+alignas(64) static std::array<uint64_t, 102400> rook_table;
+alignas(64) static std::array<uint64_t, 5248> bishop_table;
+
+#if defined(PEXT_RUNTIME_DISPATCH)
+__attribute__((target("bmi2"))) uint64_t pext(uint64_t bits, uint64_t mask) {
+  return _pext_u64(bits, mask);
+}
+#elif !defined(__BMI2__)
+uint64_t pext(uint64_t bits, uint64_t mask) {
+  uint64_t result = 0;
+  for (uint64_t bit = 1; mask != 0; bit <<= 1) {
+    if (bits & mask & -mask) {
+      result |= bit;
+    }
+    mask &= mask - 1;
+  }
+  return result;
+}
+#endif
+
+bool cpu_supports_pext() {
+#if defined(__BMI2__)
+  return true;
+#elif defined(PEXT_RUNTIME_DISPATCH)
+  return __builtin_cpu_supports("bmi2");
+#else
+  return false;
+#endif
+}
+
+bool cpu_supports_avx2() {
+#if defined(__AVX2__)
+  return true;
+#elif defined(AVX2_RUNTIME_DISPATCH)
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+bool avx2_enabled = cpu_supports_avx2();
+
+// the squares a shift may land on without wrapping around to another rank
+static constexpr uint64_t NOT_A_FILE = ~MASKS.files[0];
+static constexpr uint64_t NOT_H_FILE = ~MASKS.files[7];
+static constexpr uint64_t NO_WRAP = ~(uint64_t)0;
+
+// shifts towards higher squares, which are east and south
+static uint64_t fill_up(uint64_t sliders, uint64_t empty, int shift,
+                        uint64_t wrap) {
+  uint64_t propagators = empty & wrap;
+  sliders |= propagators & (sliders << shift);
+  propagators &= propagators << shift;
+  sliders |= propagators & (sliders << 2 * shift);
+  propagators &= propagators << 2 * shift;
+  sliders |= propagators & (sliders << 4 * shift);
+  return (sliders << shift) & wrap;
+}
+
+static uint64_t fill_down(uint64_t sliders, uint64_t empty, int shift,
+                          uint64_t wrap) {
+  uint64_t propagators = empty & wrap;
+  sliders |= propagators & (sliders >> shift);
+  propagators &= propagators >> shift;
+  sliders |= propagators & (sliders >> 2 * shift);
+  propagators &= propagators >> 2 * shift;
+  sliders |= propagators & (sliders >> 4 * shift);
+  return (sliders >> shift) & wrap;
+}
+
+uint64_t sliders_scalar(uint64_t rooks, uint64_t bishops, uint64_t occupied) {
+  const uint64_t empty = ~occupied;
+  return fill_up(rooks, empty, 1, NOT_A_FILE) |
+         fill_up(rooks, empty, 8, NO_WRAP) |
+         fill_up(bishops, empty, 9, NOT_A_FILE) |
+         fill_up(bishops, empty, 7, NOT_H_FILE) |
+         fill_down(rooks, empty, 1, NOT_H_FILE) |
+         fill_down(rooks, empty, 8, NO_WRAP) |
+         fill_down(bishops, empty, 9, NOT_H_FILE) |
+         fill_down(bishops, empty, 7, NOT_A_FILE);
+}
+
+#if defined(AVX2_TARGET)
+// the lanes hold the same four directions as the scalar fills, which are
+// shifted up, and the four opposite directions are shifted down
+AVX2_TARGET uint64_t sliders_avx2(uint64_t rooks, uint64_t bishops,
+                                  uint64_t occupied) {
+  const __m256i shift = _mm256_setr_epi64x(1, 8, 9, 7);
+  const __m256i shift2 = _mm256_add_epi64(shift, shift);
+  const __m256i shift4 = _mm256_add_epi64(shift2, shift2);
+  const __m256i wrap_up =
+      _mm256_setr_epi64x(NOT_A_FILE, NO_WRAP, NOT_A_FILE, NOT_H_FILE);
+  const __m256i wrap_down =
+      _mm256_setr_epi64x(NOT_H_FILE, NO_WRAP, NOT_H_FILE, NOT_A_FILE);
+  const __m256i sliders = _mm256_setr_epi64x(rooks, rooks, bishops, bishops);
+  const __m256i empty = _mm256_set1_epi64x(~occupied);
+
+  __m256i up = sliders;
+  __m256i propagators = _mm256_and_si256(empty, wrap_up);
+  up = _mm256_or_si256(
+      up, _mm256_and_si256(propagators, _mm256_sllv_epi64(up, shift)));
+  propagators =
+      _mm256_and_si256(propagators, _mm256_sllv_epi64(propagators, shift));
+  up = _mm256_or_si256(
+      up, _mm256_and_si256(propagators, _mm256_sllv_epi64(up, shift2)));
+  propagators =
+      _mm256_and_si256(propagators, _mm256_sllv_epi64(propagators, shift2));
+  up = _mm256_or_si256(
+      up, _mm256_and_si256(propagators, _mm256_sllv_epi64(up, shift4)));
+  up = _mm256_and_si256(_mm256_sllv_epi64(up, shift), wrap_up);
+
+  __m256i down = sliders;
+  propagators = _mm256_and_si256(empty, wrap_down);
+  down = _mm256_or_si256(
+      down, _mm256_and_si256(propagators, _mm256_srlv_epi64(down, shift)));
+  propagators =
+      _mm256_and_si256(propagators, _mm256_srlv_epi64(propagators, shift));
+  down = _mm256_or_si256(
+      down, _mm256_and_si256(propagators, _mm256_srlv_epi64(down, shift2)));
+  propagators =
+      _mm256_and_si256(propagators, _mm256_srlv_epi64(propagators, shift2));
+  down = _mm256_or_si256(
+      down, _mm256_and_si256(propagators, _mm256_srlv_epi64(down, shift4)));
+  down = _mm256_and_si256(_mm256_srlv_epi64(down, shift), wrap_down);
+
+  const __m256i attacks = _mm256_or_si256(up, down);
+  const __m128i halves = _mm_or_si128(_mm256_castsi256_si128(attacks),
+                                      _mm256_extracti128_si256(attacks, 1));
+  return _mm_cvtsi128_si64(halves) | _mm_extract_epi64(halves, 1);
+}
+#else
+uint64_t sliders_avx2(uint64_t rooks, uint64_t bishops, uint64_t occupied) {
+  return sliders_scalar(rooks, bishops, occupied);
+}
+#endif
+
+// Hyperbola Quintessence, only used to fill the tables
+// https://www.chessprogramming.org/Hyperbola_Quintessence
+static uint64_t sliding_attacks(int start, uint64_t occupied, uint64_t mask) {
+  uint64_t forward = 0;
+  uint64_t reverse = 0;
+  forward = occupied & mask;
+  reverse = bits::reverse(forward);
+  forward -= 2 * MASKS.squares[start];
+  reverse -= 2 * bits::reverse(MASKS.squares[start]);
+  forward ^= bits::reverse(reverse);
+  forward &= mask;
+  return forward;
+}
+
+uint64_t rook_attacks_slow(int square, uint64_t occupied) {
+  const int file = square % 8;
+  const int rank = square / 8;
+  return sliding_attacks(square, occupied, MASKS.files[file]) |
+         sliding_attacks(square, occupied, MASKS.ranks[rank]);
+}
+
+uint64_t bishop_attacks_slow(int square, uint64_t occupied) {
+  const int file = square % 8;
+  const int rank = square / 8;
+  return sliding_attacks(square, occupied, MASKS.diags[file + rank]) |
+         sliding_attacks(square, occupied, MASKS.antidiags[file - rank + 7]);
+}
+
+// the squares whose occupancy affects the attacks,
+// the last square of each ray never blocks anything behind it
+static uint64_t rook_mask(int square) {
+  const int file = square % 8;
+  const int rank = square / 8;
+  const uint64_t file_mask =
+      MASKS.files[file] & ~(MASKS.ranks[0] | MASKS.ranks[7]);
+  const uint64_t rank_mask =
+      MASKS.ranks[rank] & ~(MASKS.files[0] | MASKS.files[7]);
+  return (file_mask | rank_mask) & ~MASKS.squares[square];
+}
+
+static uint64_t bishop_mask(int square) {
+  const int file = square % 8;
+  const int rank = square / 8;
+  const uint64_t edges =
+      MASKS.files[0] | MASKS.files[7] | MASKS.ranks[0] | MASKS.ranks[7];
+  return (MASKS.diags[file + rank] | MASKS.antidiags[file - rank + 7]) &
+         ~edges & ~MASKS.squares[square];
+}
+
+// https://www.chessprogramming.org/Xorshift
+static uint64_t next_random(uint64_t &state) {
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  return state * 2685821657736338717ULL;
+}
+
+// magics with few bits set are more likely to work
+static uint64_t sparse_random(uint64_t &state) {
+  return next_random(state) & next_random(state) & next_random(state);
+}
+
+static void init_square(SliderSquare &s, int square, uint64_t *table,
+                        uint64_t mask, uint64_t (*slow)(int, uint64_t),
+                        bool use_pext, uint64_t &state) {
+  const int bits = bits::nr_bits_set(mask);
+  const int size = 1 << bits;
+  s.mask = mask;
+  s.shift = 64 - bits;
+  s.attacks = table;
+
+  std::array<uint64_t, 4096> occupancies;
+  std::array<uint64_t, 4096> square_attacks;
+  int n = 0;
+  uint64_t subset = 0;
+  do {
+    occupancies[n] = subset;
+    square_attacks[n] = slow(square, subset);
+    n++;
+    subset = (subset - mask) & mask;
+  } while (subset != 0);
+
+  if (use_pext) {
+    s.magic = 0;
+    for (int i = 0; i < n; i++) {
+      table[pext(occupancies[i], mask)] = square_attacks[i];
+    }
+    return;
+  }
+
+  // try random magics until one maps every occupancy to an index
+  // that is either unused or already holds the same attacks
+  std::array<int, 4096> used_by;
+  while (true) {
+    s.magic = sparse_random(state);
+    if (bits::nr_bits_set((mask * s.magic) >> 56) < 6) {
+      continue;
+    }
+    std::fill(used_by.begin(), used_by.begin() + size, -1);
+    bool collision = false;
+    for (int i = 0; i < n && !collision; i++) {
+      const uint64_t index = (occupancies[i] * s.magic) >> s.shift;
+      if (used_by[index] == -1) {
+        used_by[index] = i;
+        table[index] = square_attacks[i];
+      } else if (table[index] != square_attacks[i]) {
+        collision = true;
+      }
+    }
+    if (!collision) {
+      return;
+    }
+  }
+}
+
+void init(bool use_pext) {
+  uint64_t state = 728340911;
+  uint64_t *rook_entry = rook_table.data();
+  uint64_t *bishop_entry = bishop_table.data();
+  for (int square = 0; square < 64; square++) {
+    const uint64_t rook = rook_mask(square);
+    init_square(rook_squares[square], square, rook_entry, rook,
+                rook_attacks_slow, use_pext, state);
+    rook_entry += 1 << bits::nr_bits_set(rook);
+
+    const uint64_t bishop = bishop_mask(square);
+    init_square(bishop_squares[square], square, bishop_entry, bishop,
+                bishop_attacks_slow, use_pext, state);
+    bishop_entry += 1 << bits::nr_bits_set(bishop);
+  }
+  pext_enabled = use_pext;
+}
+
+static const bool initialized = (init(cpu_supports_pext()), true);
+
+} // namespace attacks
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// Sliding piece attacks looked up in precomputed tables.
+// The table index of an occupancy is either found with a fancy magic
+// multiplication, or with the BMI2 PEXT instruction when the CPU supports it.
+// https://www.chessprogramming.org/Magic_Bitboards
+namespace attacks {
+
+struct SliderSquare {
+  uint64_t mask;
+  uint64_t magic;
+  const uint64_t *attacks;
+  int shift;
+};
+
+extern SliderSquare rook_squares[64];
+extern SliderSquare bishop_squares[64];
+extern bool pext_enabled;
+// set at startup when the CPU supports AVX2, and can be turned off
+extern bool avx2_enabled;
+
+void init(bool use_pext);
+bool cpu_supports_pext();
+bool cpu_supports_avx2();
+
+uint64_t rook_attacks_slow(int square, uint64_t occupied);
+uint64_t bishop_attacks_slow(int square, uint64_t occupied);
+
+#if defined(__BMI2__)
+inline uint64_t pext(uint64_t bits, uint64_t mask) {
+  return _pext_u64(bits, mask);
+}
+#else
+uint64_t pext(uint64_t bits, uint64_t mask);
+#endif
+
+inline uint64_t index(const SliderSquare &s, uint64_t occupied) {
+  if (pext_enabled) {
+    return pext(occupied, s.mask);
+  }
+  return ((occupied & s.mask) * s.magic) >> s.shift;
+}
+
+inline uint64_t rook(int square, uint64_t occupied) {
+  const SliderSquare &s = rook_squares[square];
+  return s.attacks[index(s, occupied)];
+}
+
+inline uint64_t bishop(int square, uint64_t occupied) {
+  const SliderSquare &s = bishop_squares[square];
+  return s.attacks[index(s, occupied)];
+}
+
+inline uint64_t queen(int square, uint64_t occupied) {
+  return rook(square, occupied) | bishop(square, occupied);
+}
+
+// The squares attacked by a whole set of sliding pieces at once, where queens
+// belong to both the rooks and the bishops. Each direction is filled with
+// three shifts, and with AVX2 four of the eight directions are filled at once
+// https://www.chessprogramming.org/Kogge-Stone_Algorithm
+uint64_t sliders_scalar(uint64_t rooks, uint64_t bishops, uint64_t occupied);
+uint64_t sliders_avx2(uint64_t rooks, uint64_t bishops, uint64_t occupied);
+
+inline uint64_t sliders(uint64_t rooks, uint64_t bishops, uint64_t occupied) {
+  if (avx2_enabled) {
+    return sliders_avx2(rooks, bishops, occupied);
+  }
+  return sliders_scalar(rooks, bishops, occupied);
+}
+
+} // namespace attacks
@@ -1,15 +1,114 @@
 #pragma once
 
-#include <optional>
+#include <cassert>
 #include <stdint.h>
 #include <string>
 
+// The bit operations are compiled to single instructions (tzcnt, popcnt,
+// bswap, blsr) through the compiler intrinsics when they are available,
+// and to portable software implementations otherwise.
+#if defined(__GNUC__) || defined(__clang__)
+#define BITS_GCC_BUILTINS
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#include <stdlib.h>
+#define BITS_MSVC_INTRINSICS
+#endif
+
 namespace bits {
-uint64_t get(uint64_t bits, int n);
-void set(uint64_t &bits, int n);
-void unset(uint64_t &bits, int n);
-std::optional<int> popLSB(uint64_t &bits);
+
+inline uint64_t get(uint64_t bits, int n) { return (bits >> n) & (uint64_t)1; }
+inline void set(uint64_t &bits, int n) { bits |= (uint64_t)1 << n; }
+inline void unset(uint64_t &bits, int n) { bits ^= (uint64_t)1 << n; }
+
 std::string to_string(uint64_t bits);
-uint64_t reverse(uint64_t bits);
-int nr_bits_set(uint64_t bits);
+
+#if !defined(BITS_GCC_BUILTINS) && !defined(BITS_MSVC_INTRINSICS)
+int lsb_software(uint64_t bits);
+int nr_bits_set_software(uint64_t bits);
+uint64_t byteswap_software(uint64_t bits);
+#endif
+
+// the index of the least significant set bit, the bits must not be empty
+inline int lsb(uint64_t bits) {
+  assert(bits != 0);
+#if defined(BITS_GCC_BUILTINS)
+  return __builtin_ctzll(bits);
+#elif defined(BITS_MSVC_INTRINSICS)
+  unsigned long index;
+  _BitScanForward64(&index, bits);
+  return (int)index;
+#else
+  return lsb_software(bits);
+#endif
+}
+
+inline uint64_t clear_lsb(uint64_t bits) { return bits & (bits - 1); }
+
+// unsets the least significant set bit and returns its index,
+// the bits must not be empty
+inline int popLSB(uint64_t &bits) {
+  const int i = lsb(bits);
+  bits = clear_lsb(bits);
+  return i;
+}
+
+inline int nr_bits_set(uint64_t bits) {
+#if defined(BITS_GCC_BUILTINS)
+  return __builtin_popcountll(bits);
+#elif defined(BITS_MSVC_INTRINSICS)
+  return (int)__popcnt64(bits);
+#else
+  return nr_bits_set_software(bits);
+#endif
+}
+
+inline uint64_t byteswap(uint64_t bits) {
+#if defined(BITS_GCC_BUILTINS)
+  return __builtin_bswap64(bits);
+#elif defined(BITS_MSVC_INTRINSICS)
+  return _byteswap_uint64(bits);
+#else
+  return byteswap_software(bits);
+#endif
+}
+
+// reverses the order of all the bits,
+// by reversing the bits within every byte and then the order of the bytes
+inline uint64_t reverse(uint64_t b) {
+  b = (b & 0x5555555555555555) << 1 | ((b >> 1) & 0x5555555555555555);
+  b = (b & 0x3333333333333333) << 2 | ((b >> 2) & 0x3333333333333333);
+  b = (b & 0x0f0f0f0f0f0f0f0f) << 4 | ((b >> 4) & 0x0f0f0f0f0f0f0f0f);
+  return byteswap(b);
+}
+
+// The indices of the set bits, from the least significant,
+// so that a bitboard can be looped over with a range-based for loop:
+// for (const int pos : bits::SetBits(bb))
+class SetBits {
+public:
+  class Iterator {
+  public:
+    explicit Iterator(uint64_t bits) : bits(bits) {}
+
+    int operator*() const { return lsb(bits); }
+    Iterator &operator++() {
+      bits = clear_lsb(bits);
+      return *this;
+    }
+    bool operator!=(const Iterator &other) const { return bits != other.bits; }
+
+  private:
+    uint64_t bits;
+  };
+
+  explicit SetBits(uint64_t bits) : bits(bits) {}
+
+  Iterator begin() const { return Iterator(bits); }
+  Iterator end() const { return Iterator(0); }
+
+private:
+  uint64_t bits;
+};
+
 } // namespace bits
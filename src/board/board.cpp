@@ -1,4 +1,5 @@
 #include "board.hpp"
+#include "attacks.hpp"
 #include "bits.hpp"
 #include "defs.hpp"
 #include "evaluation/evaluation.hpp"
@@ -6,27 +7,31 @@
 #include "fmt/core.h"
 #include "move.hpp"
 #include "utils.hpp"
+#include "zobrist.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <optional>
 #include <stdint.h>
 
 Board::Board(std::vector<Piece> pieces, Color player_to_move,
              std::array<Castling, 2> castling_rights,
              std::optional<int> en_passant_square, int halfmove_clock,
-             int fullmove_number)
-    : masks(create_masks()) {
-
+             int fullmove_number) {
   for (int color = 0; color < 2; color++) {
     for (int piece = 0; piece < 6; piece++) {
       piece_bbs.at(color).at(piece) = 0;
     }
   }
+  mailbox.fill(EMPTY_SQUARE);
   for (const Piece &piece : pieces) {
     bits::set(piece_bbs.at(piece.color).at(piece.piece_type), piece.pos);
+    mailbox.at(piece.pos) = piece.piece_type;
   }
 
   std::array<int, 2> material;
   std::array<int, 2> psqt;
+  uint64_t hash = 0;
   for (int color = 0; color < 2; color++) {
     side_bbs.at(color) = 0;
     int material_side = 0;
@@ -39,47 +44,75 @@ Board::Board(std::vector<Piece> pieces, Color player_to_move,
       material_side +=
           bits::nr_bits_set(piece_bb) * get_piece_value(piece_type);
 
-      std::optional<int> pos = bits::popLSB(piece_bb);
-      while (pos.has_value()) {
+      for (const int pos : bits::SetBits(piece_bb)) {
         psqt_side +=
-            get_psqt_score(piece_type, pos.value(), (Color)color, false, false);
-        pos = bits::popLSB(piece_bb);
+            get_psqt_score(piece_type, pos, (Color)color, false, false);
+        hash ^= zobrist::piece(piece_type, (Color)color, pos);
       }
     }
     material.at(color) = material_side;
     psqt.at(color) = psqt_side;
   }
 
-  std::stack<PosData> history;
-  PosData pos_data = {
-      .player_to_move = player_to_move,
-      .castling_rights = castling_rights,
-      .en_passant_square = en_passant_square,
-      .halfmove_clock = halfmove_clock,
-      .fullmove_number = fullmove_number,
-      .captured_piece = std::nullopt,
+  if (player_to_move == BLACK) {
+    hash ^= zobrist::keys.black_to_move;
+  }
+  uint8_t castling_rights_bits = 0;
+  for (int color = 0; color < 2; color++) {
+    if (castling_rights.at(color).kingside) {
+      castling_rights_bits |= castling_right((Color)color, true);
+    }
+    if (castling_rights.at(color).queenside) {
+      castling_rights_bits |= castling_right((Color)color, false);
+    }
+  }
+  hash ^= zobrist::castling(castling_rights_bits);
+  if (en_passant_square.has_value()) {
+    hash ^= zobrist::en_passant(en_passant_square.value());
+  }
+
+  ply = 0;
+  attack_computations = 0;
+  history[ply] = {
+      .hash = hash,
+      .occupied = side_bbs.at(WHITE) | side_bbs.at(BLACK),
+      .checkers = 0,
+      .pinned = 0,
+      .bishop_check_squares = 0,
+      .rook_check_squares = 0,
+      .discoverers = 0,
       .material = material,
       .psqt = psqt,
+      .halfmove_clock = (uint16_t)halfmove_clock,
+      .fullmove_number = (uint16_t)fullmove_number,
+      .move = Move::from_data(0),
+      .castling_rights = castling_rights_bits,
+      .player_to_move = (uint8_t)player_to_move,
+      .en_passant_square = (int8_t)en_passant_square.value_or(NO_SQUARE),
+      .moved_piece = EMPTY_SQUARE,
+      .captured_piece = EMPTY_SQUARE,
+      .check_info_computed = false,
+      .check_squares_computed = false,
   };
-  history.push(pos_data);
-  this->history = history;
-
-  std::stack<Move> moves;
-  this->move_history = moves;
 }
 
-Board Board::get_starting_position() {
-  return fen::get_position(STARTING_POSITION_FEN);
-}
+Board::Board(const Board &other) { *this = other; }
 
-Board Board::operator=(Board other) {
+Board &Board::operator=(const Board &other) {
   piece_bbs = other.piece_bbs;
   side_bbs = other.side_bbs;
-  history = other.history;
-  move_history = other.move_history;
+  mailbox = other.mailbox;
+  ply = other.ply;
+  attack_computations = other.attack_computations;
+  std::memcpy(history.data(), other.history.data(),
+              (ply + 1) * sizeof(PosData));
   return *this;
 }
 
+Board Board::get_starting_position() {
+  return fen::get_position(STARTING_POSITION_FEN);
+}
+
 bool Board::operator==(const Board &other) const {
   for (int color = 0; color < 2; color++) {
     for (int piece = 0; piece < 6; piece++) {
@@ -97,34 +130,84 @@ bool Board::is_draw() const {
          is_draw_by_fifty_move_rule();
 }
 
-std::optional<PieceType> Board::get_piece_type(int pos) const {
-  for (int color = 0; color < 2; color++) {
-    for (int piece = 0; piece < 6; piece++) {
-      uint64_t bitboard_bit = bits::get(piece_bbs.at(color).at(piece), pos);
-      if (bitboard_bit == 1) {
-        return (PieceType)piece;
-      }
-    }
-  }
-  return std::nullopt;
+Color Board::get_player_to_move() const {
+  return (Color)history[ply].player_to_move;
 }
 
-Color Board::get_player_to_move() const { return history.top().player_to_move; }
-
-int Board::get_halfmove_clock() const { return history.top().halfmove_clock; }
-int Board::get_fullmove_number() const { return history.top().fullmove_number; }
+int Board::get_halfmove_clock() const { return history[ply].halfmove_clock; }
+int Board::get_fullmove_number() const { return history[ply].fullmove_number; }
 std::optional<int> Board::get_en_passant_square() const {
-  return history.top().en_passant_square;
+  if (history[ply].en_passant_square == NO_SQUARE) {
+    return std::nullopt;
+  }
+  return history[ply].en_passant_square;
+}
+// the square of the pawn captured en passant by the given color,
+// which is behind the en passant square
+static int en_passant_capture_pos(int en_passant_square, Color color) {
+  return en_passant_square + (color == WHITE ? 8 : -8);
 }
+
 std::optional<Piece> Board::get_captured_piece() const {
-  return history.top().captured_piece;
+  const PosData &pos_data = history[ply];
+  if (pos_data.captured_piece == EMPTY_SQUARE) {
+    return std::nullopt;
+  }
+  // the captured piece belongs to the player to move now,
+  // and an en passant capture takes the pawn behind the en passant square
+  const Color color = get_player_to_move();
+  const int pos = pos_data.move.get_move_type() == EN_PASSANT
+                      ? en_passant_capture_pos(
+                            history[ply - 1].en_passant_square,
+                            get_opposite_color(color))
+                      : pos_data.move.get_end();
+  return Piece((PieceType)pos_data.captured_piece, color, pos);
 }
 
 int Board::get_material(Color color) const {
-  return history.top().material.at(color);
+  return history[ply].material.at(color);
 }
 
-int Board::get_psqt(Color color) const { return history.top().psqt.at(color); }
+int Board::get_psqt(Color color) const { return history[ply].psqt.at(color); }
+
+uint64_t Board::get_hash() const { return history[ply].hash; }
+
+int Board::get_ply() const { return ply; }
+
+uint64_t Board::get_checkers() const {
+  if (!history[ply].check_info_computed) {
+    compute_check_info();
+  }
+  return history[ply].checkers;
+}
+
+uint64_t Board::get_pinned() const {
+  if (!history[ply].check_info_computed) {
+    compute_check_info();
+  }
+  return history[ply].pinned;
+}
+
+void Board::compute_check_info() const {
+  const Color player = get_player_to_move();
+  const int king_pos = bits::lsb(piece_bbs.at(player).at(KING));
+  const PosData &pos_data = history[ply];
+  pos_data.checkers =
+      get_attackers(king_pos, get_opposite_color(player), get_occupied());
+  pos_data.pinned = find_blockers(king_pos, player, player);
+  pos_data.check_info_computed = true;
+}
+
+void Board::compute_check_squares() const {
+  const Color player = get_player_to_move();
+  const Color opponent = get_opposite_color(player);
+  const int king_pos = bits::lsb(piece_bbs.at(opponent).at(KING));
+  const PosData &pos_data = history[ply];
+  pos_data.bishop_check_squares = attacks::bishop(king_pos, get_occupied());
+  pos_data.rook_check_squares = attacks::rook(king_pos, get_occupied());
+  pos_data.discoverers = find_blockers(king_pos, opponent, player);
+  pos_data.check_squares_computed = true;
+}
 
 bool Board::is_lone_king(Color color) const {
   return bits::nr_bits_set(side_bbs.at(color)) == 1;
@@ -151,60 +234,27 @@ std::string Board::to_string() const {
   return board;
 }
 
-std::array<Castling, 2> Board::updated_castling_rights(const Move &move) const {
-  int kingside_rook;
-  int queenside_rook;
-  int king;
-  int opponent_kingside_rook;
-  int opponent_queenside_rook;
-  if (get_player_to_move() == WHITE) {
-    kingside_rook = 63;
-    queenside_rook = 56;
-    king = 60;
-    opponent_kingside_rook = 7;
-    opponent_queenside_rook = 0;
-  } else {
-    kingside_rook = 7;
-    queenside_rook = 0;
-    king = 4;
-    opponent_kingside_rook = 63;
-    opponent_queenside_rook = 56;
+// the castling rights that are kept when a piece moves from or to a square,
+// since moving the king or a rook, or capturing a rook, loses them
+static constexpr std::array<uint8_t, 64> castling_rights_kept() {
+  std::array<uint8_t, 64> kept{};
+  for (int pos = 0; pos < 64; pos++) {
+    kept[pos] = 0xF;
   }
-  bool disable_kingside_player =
-      move.start == kingside_rook || move.start == king;
-  bool disable_queenside_player =
-      move.start == queenside_rook || move.start == king;
-
-  std::array<Castling, 2> castling_rights;
-  castling_rights.at(get_player_to_move()) = {
-      .kingside =
-          disable_kingside_player
-              ? false
-              : history.top().castling_rights.at(get_player_to_move()).kingside,
-      .queenside = disable_queenside_player
-                       ? false
-                       : history.top()
-                             .castling_rights.at(get_player_to_move())
-                             .queenside,
-  };
-
-  Color opponent = get_opposite_color(get_player_to_move());
-  bool disable_kingside_opponent = move.end == opponent_kingside_rook;
-  bool disable_queenside_opponent = move.end == opponent_queenside_rook;
-  castling_rights.at(opponent) = {
-      .kingside = disable_kingside_opponent
-                      ? false
-                      : history.top().castling_rights.at(opponent).kingside,
-      .queenside = disable_queenside_opponent
-                       ? false
-                       : history.top().castling_rights.at(opponent).queenside,
-  };
-
-  return castling_rights;
+  kept[e1] &= ~(castling_right(WHITE, true) | castling_right(WHITE, false));
+  kept[h1] &= ~castling_right(WHITE, true);
+  kept[a1] &= ~castling_right(WHITE, false);
+  kept[e8] &= ~(castling_right(BLACK, true) | castling_right(BLACK, false));
+  kept[h8] &= ~castling_right(BLACK, true);
+  kept[a8] &= ~castling_right(BLACK, false);
+  return kept;
 }
 
-int Board::get_castling_rook(const Move &move, Color color) const {
-  int kingside = move.end > move.start;
+static constexpr std::array<uint8_t, 64> CASTLING_RIGHTS_KEPT =
+    castling_rights_kept();
+
+int Board::get_castling_rook(const Move &move, Color color) {
+  int kingside = move.get_end() > move.get_start();
   if (kingside) {
     return color == WHITE ? 63 : 7;
   } else {
@@ -212,202 +262,328 @@ int Board::get_castling_rook(const Move &move, Color color) const {
   }
 }
 
-std::optional<PieceType> Board::piece_type(int pos, Color color) const {
-  std::array<uint64_t, NR_PIECES> side_bb = piece_bbs.at(color);
-  for (int piece = 0; piece < NR_PIECES; piece++) {
-    uint64_t piece_bb = side_bb.at(piece);
-    if (bits::get(piece_bb, pos) == 1) {
-      return (PieceType)piece;
+// removes a captured piece from the hash, material and psqt of the position
+static void remove_captured(PosData &pos_data, PieceType piece_type,
+                            Color color, int pos) {
+  pos_data.hash ^= zobrist::piece(piece_type, color, pos);
+  pos_data.material[color] -= get_piece_value(piece_type);
+  pos_data.psqt[color] -= get_psqt_score(piece_type, pos, color, false, false);
+  pos_data.halfmove_clock = 0;
+  pos_data.captured_piece = piece_type;
+}
+
+PosData Board::updated_pos_data(const Move &move) const {
+  const PosData &pos_data = history[ply];
+  const Color player = (Color)pos_data.player_to_move;
+  const Color opponent = get_opposite_color(player);
+  const int start = move.get_start();
+  const int end = move.get_end();
+  assert(mailbox[start] != EMPTY_SQUARE);
+  const PieceType piece_type = (PieceType)mailbox[start];
+
+  PosData next = {
+      .hash = pos_data.hash ^ zobrist::keys.black_to_move ^
+              zobrist::piece(piece_type, player, start),
+      // set once the pieces have been moved
+      .occupied = 0,
+      .checkers = 0,
+      .pinned = 0,
+      .bishop_check_squares = 0,
+      .rook_check_squares = 0,
+      .discoverers = 0,
+      .material = pos_data.material,
+      .psqt = pos_data.psqt,
+      .halfmove_clock = piece_type == PAWN
+                            ? (uint16_t)0
+                            : (uint16_t)(pos_data.halfmove_clock + 1),
+      .fullmove_number = (uint16_t)(pos_data.fullmove_number +
+                                    (player == BLACK ? 1 : 0)),
+      .move = move,
+      .castling_rights = (uint8_t)(pos_data.castling_rights &
+                                   CASTLING_RIGHTS_KEPT[start] &
+                                   CASTLING_RIGHTS_KEPT[end]),
+      .player_to_move = (uint8_t)opponent,
+      .en_passant_square = NO_SQUARE,
+      .moved_piece = (uint8_t)piece_type,
+      .captured_piece = EMPTY_SQUARE,
+      .check_info_computed = false,
+      .check_squares_computed = false,
+  };
+  if (next.castling_rights != pos_data.castling_rights) {
+    next.hash ^= zobrist::castling(pos_data.castling_rights) ^
+                 zobrist::castling(next.castling_rights);
+  }
+  if (pos_data.en_passant_square != NO_SQUARE) {
+    next.hash ^= zobrist::en_passant(pos_data.en_passant_square);
+  }
+
+  // only the king's psqt score depends on the rest of the position
+  const bool is_king = piece_type == KING;
+  const bool endgame = is_king && is_endgame();
+  const bool lone_king = is_king && is_lone_king(player);
+  next.psqt[player] -=
+      get_psqt_score(piece_type, start, player, lone_king, endgame);
+
+  PieceType new_piece_type = piece_type;
+  switch (move.get_move_type()) {
+  case NORMAL:
+    if (mailbox[end] != EMPTY_SQUARE) {
+      remove_captured(next, (PieceType)mailbox[end], opponent, end);
+    }
+    break;
+  case PAWN_TWO_SQUARES_FORWARD:
+    next.en_passant_square = (start + end) / 2;
+    next.hash ^= zobrist::en_passant(next.en_passant_square);
+    break;
+  case EN_PASSANT:
+    remove_captured(
+        next, PAWN, opponent,
+        en_passant_capture_pos(pos_data.en_passant_square, player));
+    break;
+  case PROMOTION:
+    if (mailbox[end] != EMPTY_SQUARE) {
+      remove_captured(next, (PieceType)mailbox[end], opponent, end);
     }
+    new_piece_type = move.get_promotion_piece().value();
+    next.material[player] +=
+        get_piece_value(new_piece_type) - get_piece_value(PAWN);
+    break;
+  case CASTLING: {
+    const int rook_start = get_castling_rook(move, player);
+    const int rook_end = rook_start + (end > start ? -2 : 3);
+    next.hash ^= zobrist::piece(ROOK, player, rook_start) ^
+                 zobrist::piece(ROOK, player, rook_end);
+    next.psqt[player] +=
+        get_psqt_score(ROOK, rook_end, player, false, false) -
+        get_psqt_score(ROOK, rook_start, player, false, false);
+    break;
   }
-  return std::nullopt;
+  }
+
+  next.hash ^= zobrist::piece(new_piece_type, player, end);
+  next.psqt[player] +=
+      get_psqt_score(new_piece_type, end, player, lone_king, endgame);
+  return next;
 }
 
-std::optional<Piece> Board::get_piece_to_be_captured(const Move &move) const {
-  Color player = get_player_to_move();
-  Color opponent = get_opposite_color(player);
-  int pos = move.move_type == EN_PASSANT
-                ? get_en_passant_square().value() + (player == WHITE ? 8 : -8)
-                : move.end;
-  std::optional<PieceType> piece_type_opt = piece_type(pos, opponent);
-  return piece_type_opt.has_value()
-             ? std::optional<Piece>(
-                   Piece(piece_type_opt.value(), opponent, pos))
-             : std::nullopt;
+// moves the pieces on the given bitboards and mailbox,
+// which are either the board's own or those of a snapshot
+void Board::move_pieces(const Move &move, const PosData &pos_data,
+                        int en_passant_square,
+                        std::array<std::array<uint64_t, 6>, 2> &piece_bbs,
+                        std::array<uint64_t, 2> &side_bbs,
+                        std::array<uint8_t, 64> &mailbox) {
+  const Color color = get_opposite_color((Color)pos_data.player_to_move);
+  const Color opponent = get_opposite_color(color);
+  const PieceType piece_type = (PieceType)pos_data.moved_piece;
+  const int start = move.get_start();
+  const int end = move.get_end();
+  const uint64_t start_end = MASKS.squares[start] | MASKS.squares[end];
+
+  switch (move.get_move_type()) {
+  case NORMAL:
+  case PAWN_TWO_SQUARES_FORWARD:
+    if (pos_data.captured_piece != EMPTY_SQUARE) {
+      piece_bbs[opponent][pos_data.captured_piece] ^= MASKS.squares[end];
+      side_bbs[opponent] ^= MASKS.squares[end];
+    }
+    piece_bbs[color][piece_type] ^= start_end;
+    side_bbs[color] ^= start_end;
+    mailbox[end] = piece_type;
+    break;
+  case EN_PASSANT: {
+    const int captured_pos = en_passant_capture_pos(en_passant_square, color);
+    piece_bbs[opponent][PAWN] ^= MASKS.squares[captured_pos];
+    side_bbs[opponent] ^= MASKS.squares[captured_pos];
+    mailbox[captured_pos] = EMPTY_SQUARE;
+    piece_bbs[color][PAWN] ^= start_end;
+    side_bbs[color] ^= start_end;
+    mailbox[end] = PAWN;
+    break;
+  }
+  case PROMOTION: {
+    if (pos_data.captured_piece != EMPTY_SQUARE) {
+      piece_bbs[opponent][pos_data.captured_piece] ^= MASKS.squares[end];
+      side_bbs[opponent] ^= MASKS.squares[end];
+    }
+    const PieceType promotion_piece = move.get_promotion_piece().value();
+    piece_bbs[color][PAWN] ^= MASKS.squares[start];
+    piece_bbs[color][promotion_piece] ^= MASKS.squares[end];
+    side_bbs[color] ^= start_end;
+    mailbox[end] = promotion_piece;
+    break;
+  }
+  case CASTLING: {
+    const int rook_start = get_castling_rook(move, color);
+    const int rook_end = rook_start + (end > start ? -2 : 3);
+    const uint64_t rook_start_end =
+        MASKS.squares[rook_start] | MASKS.squares[rook_end];
+    piece_bbs[color][KING] ^= start_end;
+    piece_bbs[color][ROOK] ^= rook_start_end;
+    side_bbs[color] ^= start_end ^ rook_start_end;
+    mailbox[rook_start] = EMPTY_SQUARE;
+    mailbox[rook_end] = ROOK;
+    mailbox[end] = KING;
+    break;
+  }
+  }
+  mailbox[start] = EMPTY_SQUARE;
 }
 
-std::array<int, 2>
-Board::updated_material(const Move &move,
-                        std::optional<Piece> captured_piece) const {
-  const Color player_to_move = get_player_to_move();
-  const Color opponent = get_opposite_color(player_to_move);
+void Board::make(const Move &move) {
+  const int en_passant_square = history[ply].en_passant_square;
 
-  std::array<int, 2> material;
-  material.at(player_to_move) =
-      get_material(player_to_move) +
-      (move.move_type == PROMOTION
-           ? get_piece_value(move.promotion_piece.value()) -
-                 get_piece_value(PAWN)
-           : 0);
-  material.at(opponent) =
-      get_material(opponent) -
-      (captured_piece.has_value()
-           ? get_piece_value(captured_piece.value().piece_type)
-           : 0);
-  return material;
-}
-
-std::array<int, 2>
-Board::updated_psqt(const Move &move,
-                    std::optional<Piece> captured_piece) const {
-  const Color player_to_move = get_player_to_move();
-  const Color opponent = get_opposite_color(player_to_move);
-
-  const std::optional<PieceType> piece_type_optional =
-      piece_type(move.start, player_to_move);
-  assert(piece_type_optional.has_value());
-  const PieceType piece_type = piece_type_optional.value();
-  const PieceType new_piece_type =
-      move.move_type == PROMOTION ? move.promotion_piece.value() : piece_type;
-
-  bool endgame = piece_type == PieceType::KING ? is_endgame() : false;
-  bool lone_king =
-      piece_type == PieceType::KING ? is_lone_king(player_to_move) : false;
-  std::array<int, 2> psqt;
-  psqt.at(player_to_move) = get_psqt(player_to_move) -
-                            get_psqt_score(piece_type, move.start,
-                                           player_to_move, lone_king, endgame) +
-                            get_psqt_score(new_piece_type, move.end,
-                                           player_to_move, lone_king, endgame);
-  if (move.move_type == CASTLING) {
-    const int kingside = move.end > move.start;
-    const int rook_start = get_castling_rook(move, player_to_move);
-    const int rook_end = rook_start + (kingside ? -2 : 3);
-    psqt.at(player_to_move) +=
-        get_psqt_score(ROOK, rook_end, player_to_move, false, false) -
-        get_psqt_score(ROOK, rook_start, player_to_move, false, false);
+  assert(ply + 1 < HISTORY_CAPACITY);
+  history[ply + 1] = updated_pos_data(move);
+  ply++;
+
+  move_pieces(move, history[ply], en_passant_square, piece_bbs, side_bbs,
+              mailbox);
+  history[ply].occupied = side_bbs[WHITE] | side_bbs[BLACK];
+}
+
+// The position after a null move only differs in the player to move
+// and the en passant square. The halfmove clock is reset, since the
+// positions from before the null move can't be repeated with the same moves
+void Board::make_null() {
+  assert(ply + 1 < HISTORY_CAPACITY);
+  const PosData &pos_data = history[ply];
+  PosData &next = history[ply + 1];
+  next = pos_data;
+  next.hash ^= zobrist::keys.black_to_move;
+  if (pos_data.en_passant_square != NO_SQUARE) {
+    next.hash ^= zobrist::en_passant(pos_data.en_passant_square);
   }
+  next.halfmove_clock = 0;
+  next.fullmove_number += pos_data.player_to_move == BLACK ? 1 : 0;
+  next.move = Move::from_data(0);
+  next.player_to_move = get_opposite_color((Color)pos_data.player_to_move);
+  next.en_passant_square = NO_SQUARE;
+  next.moved_piece = EMPTY_SQUARE;
+  next.captured_piece = EMPTY_SQUARE;
+  next.check_info_computed = false;
+  next.check_squares_computed = false;
+  ply++;
+}
 
-  psqt.at(opponent) =
-      get_psqt(opponent) -
-      (captured_piece.has_value()
-           ? get_psqt_score(captured_piece.value().piece_type,
-                            captured_piece.value().pos,
-                            captured_piece.value().color, false, false)
-           : 0);
-  return psqt;
+void Board::undo_null() {
+  assert(ply >= 1 && last_move_was_null());
+  ply--;
 }
 
-void Board::make(const Move &move) {
+bool Board::last_move_was_null() const {
+  return ply > 0 && history[ply].moved_piece == EMPTY_SQUARE;
+}
 
-  const Color player_to_move = get_player_to_move();
-  const std::optional<PieceType> piece_type_opt =
-      piece_type(move.start, player_to_move);
-  assert(piece_type_opt.has_value());
-  const PieceType piece_type = piece_type_opt.value();
-
-  const std::optional<Piece> captured_piece_opt =
-      get_piece_to_be_captured(move);
-
-  const PosData new_pos_data = {
-      .player_to_move = get_opposite_color(player_to_move),
-      .castling_rights = updated_castling_rights(move),
-      .en_passant_square = move.move_type == PAWN_TWO_SQUARES_FORWARD
-                               ? std::optional<int>((move.start + move.end) / 2)
-                               : std::nullopt,
-      .halfmove_clock = piece_type == PAWN || captured_piece_opt.has_value()
-                            ? 0
-                            : history.top().halfmove_clock + 1,
-      .fullmove_number =
-          history.top().fullmove_number + (player_to_move == BLACK ? 1 : 0),
-      .captured_piece = captured_piece_opt,
-      .material = updated_material(move, captured_piece_opt),
-      .psqt = updated_psqt(move, captured_piece_opt),
+BoardSnapshot Board::get_snapshot() const {
+  return {
+      .piece_bbs = piece_bbs,
+      .side_bbs = side_bbs,
+      .mailbox = mailbox,
+      .pos_data = history[ply],
   };
+}
 
-  history.push(new_pos_data);
-  move_history.push(move);
-
-  uint64_t &piece_bb = piece_bbs.at(player_to_move).at(piece_type);
-  uint64_t &side_bb = side_bbs.at(player_to_move);
-
-  bits::unset(piece_bb, move.start);
-  bits::unset(side_bb, move.start);
-  bits::set(side_bb, move.end);
-  if (move.move_type == CASTLING) {
-    const int kingside = move.end > move.start;
-    const int rook = get_castling_rook(move, player_to_move);
-    const int rook_new = kingside ? rook - 2 : rook + 3;
-    uint64_t &rook_bb = piece_bbs.at(player_to_move).at(ROOK);
-    bits::unset(rook_bb, rook);
-    bits::unset(side_bb, rook);
-    bits::set(rook_bb, rook_new);
-    bits::set(side_bb, rook_new);
-    bits::set(piece_bb, move.end);
-  } else if (move.move_type == PROMOTION) {
-    assert(move.promotion_piece.has_value());
-    uint64_t &promotion_piece_bb =
-        piece_bbs.at(player_to_move).at(move.promotion_piece.value());
-    bits::set(promotion_piece_bb, move.end);
-  } else {
-    bits::set(piece_bb, move.end);
-  }
+BoardSnapshot Board::make_copy(const Move &move) const {
+  BoardSnapshot snapshot = {
+      .piece_bbs = piece_bbs,
+      .side_bbs = side_bbs,
+      .mailbox = mailbox,
+      .pos_data = updated_pos_data(move),
+  };
+  move_pieces(move, snapshot.pos_data, history[ply].en_passant_square,
+              snapshot.piece_bbs, snapshot.side_bbs, snapshot.mailbox);
+  snapshot.pos_data.occupied =
+      snapshot.side_bbs[WHITE] | snapshot.side_bbs[BLACK];
+  return snapshot;
+}
 
-  if (captured_piece_opt.has_value()) {
-    const Piece p = captured_piece_opt.value();
-    bits::unset(piece_bbs.at(p.color).at(p.piece_type), p.pos);
-    bits::unset(side_bbs.at(p.color), p.pos);
-  }
+void Board::make(const BoardSnapshot &snapshot) {
+  assert(ply + 1 < HISTORY_CAPACITY);
+  piece_bbs = snapshot.piece_bbs;
+  side_bbs = snapshot.side_bbs;
+  mailbox = snapshot.mailbox;
+  history[++ply] = snapshot.pos_data;
+}
+
+void Board::undo(const BoardSnapshot &parent) {
+  assert(ply >= 1);
+  ply--;
+  assert(history[ply].hash == parent.pos_data.hash);
+  piece_bbs = parent.piece_bbs;
+  side_bbs = parent.side_bbs;
+  mailbox = parent.mailbox;
 }
 
+// the moved and captured pieces are stored in the history,
+// so undoing a move never has to look up what was on a square
 void Board::undo() {
-  assert(move_history.size() >= 1);
-
-  const Move &move = move_history.top();
-
-  const Color move_played_by = get_opposite_color(get_player_to_move());
-  const std::optional<PieceType> piece_type_opt =
-      piece_type(move.end, move_played_by);
-  assert(piece_type_opt.has_value());
-  const PieceType piece_type = piece_type_opt.value();
-
-  uint64_t &piece_bb = piece_bbs.at(move_played_by).at(piece_type);
-  uint64_t &side_bb = side_bbs.at(move_played_by);
-
-  bits::unset(piece_bb, move.end);
-  bits::unset(side_bb, move.end);
-  bits::set(side_bb, move.start);
-
-  if (move.move_type == CASTLING) {
-    int kingside = move.end > move.start;
-    int rook = get_castling_rook(move, move_played_by);
-    int rook_new = kingside ? rook - 2 : rook + 3;
-    uint64_t &rook_bb = piece_bbs.at(move_played_by).at(ROOK);
-    bits::unset(rook_bb, rook_new);
-    bits::unset(side_bb, rook_new);
-    bits::set(rook_bb, rook);
-    bits::set(side_bb, rook);
-    bits::set(piece_bb, move.start);
-  } else if (move.move_type == PROMOTION) {
-    bits::set(piece_bbs.at(move_played_by).at(PAWN), move.start);
-  } else {
-    bits::set(piece_bb, move.start);
+  assert(ply >= 1);
+
+  const PosData &pos_data = history[ply];
+  const Move move = pos_data.move;
+  const Color color = get_opposite_color((Color)pos_data.player_to_move);
+  const Color opponent = get_opposite_color(color);
+  const PieceType piece_type = (PieceType)pos_data.moved_piece;
+  const uint8_t captured_piece = pos_data.captured_piece;
+  const int start = move.get_start();
+  const int end = move.get_end();
+  const uint64_t start_end = MASKS.squares[start] | MASKS.squares[end];
+
+  switch (move.get_move_type()) {
+  case NORMAL:
+  case PAWN_TWO_SQUARES_FORWARD:
+    piece_bbs[color][piece_type] ^= start_end;
+    side_bbs[color] ^= start_end;
+    if (captured_piece != EMPTY_SQUARE) {
+      piece_bbs[opponent][captured_piece] ^= MASKS.squares[end];
+      side_bbs[opponent] ^= MASKS.squares[end];
+    }
+    mailbox[end] = captured_piece;
+    break;
+  case EN_PASSANT: {
+    const int captured_pos = en_passant_capture_pos(
+        history[ply - 1].en_passant_square, color);
+    piece_bbs[color][PAWN] ^= start_end;
+    side_bbs[color] ^= start_end;
+    piece_bbs[opponent][PAWN] ^= MASKS.squares[captured_pos];
+    side_bbs[opponent] ^= MASKS.squares[captured_pos];
+    mailbox[captured_pos] = PAWN;
+    mailbox[end] = EMPTY_SQUARE;
+    break;
+  }
+  case PROMOTION:
+    piece_bbs[color][PAWN] ^= MASKS.squares[start];
+    piece_bbs[color][move.get_promotion_piece().value()] ^=
+        MASKS.squares[end];
+    side_bbs[color] ^= start_end;
+    if (captured_piece != EMPTY_SQUARE) {
+      piece_bbs[opponent][captured_piece] ^= MASKS.squares[end];
+      side_bbs[opponent] ^= MASKS.squares[end];
+    }
+    mailbox[end] = captured_piece;
+    break;
+  case CASTLING: {
+    const int rook_start = get_castling_rook(move, color);
+    const int rook_end = rook_start + (end > start ? -2 : 3);
+    const uint64_t rook_start_end =
+        MASKS.squares[rook_start] | MASKS.squares[rook_end];
+    piece_bbs[color][KING] ^= start_end;
+    piece_bbs[color][ROOK] ^= rook_start_end;
+    side_bbs[color] ^= start_end ^ rook_start_end;
+    mailbox[rook_end] = EMPTY_SQUARE;
+    mailbox[rook_start] = ROOK;
+    mailbox[end] = EMPTY_SQUARE;
+    break;
   }
-
-  const std::optional<Piece> captured_piece_opt = history.top().captured_piece;
-  if (captured_piece_opt.has_value()) {
-    const Piece p = captured_piece_opt.value();
-    bits::set(piece_bbs.at(p.color).at(p.piece_type), p.pos);
-    bits::set(side_bbs.at(p.color), p.pos);
   }
+  mailbox[start] = piece_type;
 
-  history.pop();
-  move_history.pop();
+  ply--;
 }
 
 bool Board::is_insufficient_material() const {
-  uint64_t all_pieces_bb = side_bbs.at(WHITE) | side_bbs.at(BLACK);
-  if (bits::nr_bits_set(all_pieces_bb) > 3) {
+  if (bits::nr_bits_set(get_occupied()) > 3) {
     return false;
   }
 
@@ -423,29 +599,37 @@ bool Board::is_insufficient_material() const {
 }
 
 bool Board::is_draw_by_fifty_move_rule() const {
-  return history.top().halfmove_clock > 100;
+  return history[ply].halfmove_clock > 100;
 }
 
 bool Board::is_threefold_repetition() const {
-  if (history.top().halfmove_clock < 5) {
+  // a position can only repeat after both players have made two reversible
+  // moves, and only positions with the same player to move can be equal
+  const int halfmove_clock = history[ply].halfmove_clock;
+  if (halfmove_clock < 4) {
     return false;
   }
 
-  Board b = *this;
-  while (!(b.move_history.empty() || history.top().halfmove_clock == 0)) {
-    b.undo();
-    if (*this == b) {
+  const uint64_t hash = get_hash();
+  const int oldest = std::max(0, ply - halfmove_clock);
+  for (int i = ply - 4; i >= oldest; i -= 2) {
+    if (history[i].hash == hash) {
       return true;
     }
   }
   return false;
 }
 
+bool Board::has_non_pawn_material(Color color) const {
+  const std::array<uint64_t, 6> &pieces = piece_bbs[color];
+  return (pieces[KNIGHT] | pieces[BISHOP] | pieces[ROOK] | pieces[QUEEN]) != 0;
+}
+
 int Board::get_doubled_pawns(Color color) const {
   uint64_t pawn_bb = piece_bbs.at(color).at(PieceType::PAWN);
   int doubled_pawns = 0;
   for (int i = 0; i < 8; i++) {
-    uint64_t pawns_file = pawn_bb & masks.files.at(i);
+    uint64_t pawns_file = pawn_bb & MASKS.files.at(i);
     if (bits::nr_bits_set(pawns_file) > 1) {
       doubled_pawns++;
     }
@@ -2,29 +2,83 @@
 
 #include <array>
 #include <optional>
-#include <stack>
+#include <stdint.h>
+#include <type_traits>
 #include <vector>
 
 #include "defs.hpp"
 #include "masks.hpp"
 #include "move.hpp"
+#include "move_list.hpp"
 #include "piece.hpp"
 
 // TODO: Maybe change squares to go from a1-h8 instead of a8-h1, might be more
 // logical
 
+const int NR_PIECES = 6;
+const uint64_t ALL_SQUARES = ~(uint64_t)0;
+const uint8_t EMPTY_SQUARE = NR_PIECES;
+const int8_t NO_SQUARE = -1;
+
+// the longest game that can be set up, in plies
+const int MAX_GAME_PLY = 1536;
+// the history also needs room for the moves made by the search
+const int HISTORY_CAPACITY = 2048;
+
+// The state of a position that can't be recovered from the pieces alone.
+// One is stored for every ply, so it is packed and trivially copyable
 struct PosData {
-  Color player_to_move;
-  std::array<Castling, 2> castling_rights;
-  std::optional<int> en_passant_square;
-  int halfmove_clock;
-  int fullmove_number;
-  std::optional<Piece> captured_piece;
+  uint64_t hash;
+  // all the pieces on the board
+  uint64_t occupied;
+  // the pieces giving check to the player to move,
+  // and the pieces of the player to move that are pinned to its king.
+  // They are computed the first time they are needed in the position
+  mutable uint64_t checkers;
+  mutable uint64_t pinned;
+  // the squares from which a bishop or rook of the player to move would
+  // attack the opponent king, and the pieces of the player to move that
+  // uncover an attack on it by moving off the line.
+  // They are computed the first time a move is tested for giving check
+  mutable uint64_t bishop_check_squares;
+  mutable uint64_t rook_check_squares;
+  mutable uint64_t discoverers;
   std::array<int, 2> material;
   std::array<int, 2> psqt;
+  uint16_t halfmove_clock;
+  uint16_t fullmove_number;
+  // the move that was made to reach the position
+  Move move;
+  // the bits given by castling_right
+  uint8_t castling_rights;
+  uint8_t player_to_move;
+  int8_t en_passant_square;
+  // the type of the piece that made the move, before any promotion,
+  // and of the piece captured by the move, or EMPTY_SQUARE.
+  // No piece moves in the first position or after a null move
+  uint8_t moved_piece;
+  uint8_t captured_piece;
+  mutable bool check_info_computed;
+  mutable bool check_squares_computed;
 };
 
-const int NR_PIECES = 6;
+static_assert(std::is_trivially_copyable_v<PosData>);
+
+// A position without its history: the pieces and the state of the current
+// ply. It is trivially copyable, so that copy-make can produce a new one for
+// every move instead of undoing the move afterwards
+struct BoardSnapshot {
+  std::array<std::array<uint64_t, 6>, 2> piece_bbs;
+  std::array<uint64_t, 2> side_bbs;
+  std::array<uint8_t, 64> mailbox;
+  PosData pos_data;
+};
+
+static_assert(std::is_trivially_copyable_v<BoardSnapshot>);
+
+// Whether a move is taken back by undoing it,
+// or by restoring a snapshot of the position from before the move
+enum MakeMode { MAKE_UNDO, COPY_MAKE };
 
 class Board {
 public:
@@ -32,10 +86,12 @@ public:
         std::array<Castling, 2> castling_rights,
         std::optional<int> en_passant_square, int halfmove_clock,
         int fullmove_number);
+  // only the part of the history that is in use is copied
+  Board(const Board &other);
+  Board &operator=(const Board &other);
 
   static Board get_starting_position();
 
-  Board operator=(Board other);
   bool operator==(const Board &other) const;
 
   Color get_player_to_move() const;
@@ -45,18 +101,62 @@ public:
   std::optional<Piece> get_captured_piece() const;
   int get_material(Color color) const;
   int get_psqt(Color color) const;
+  uint64_t get_hash() const;
+  int get_ply() const;
   int get_doubled_pawns(Color color) const;
-
-  std::optional<PieceType> get_piece_type(int pos) const;
+  // whether the color has any pieces other than pawns and the king
+  bool has_non_pawn_material(Color color) const;
+  uint64_t get_occupied() const { return history[ply].occupied; }
+  uint64_t get_checkers() const;
+  uint64_t get_pinned() const;
+  // the number of times the attacks on a square, the attacks of a side
+  // or the pins have been computed by this board
+  long get_attack_computations() const { return attack_computations; }
+
+  std::optional<PieceType> get_piece_type(int pos) const {
+    const uint8_t piece = mailbox[pos];
+    if (piece == EMPTY_SQUARE) {
+      return std::nullopt;
+    }
+    return (PieceType)piece;
+  }
 
   std::string to_string() const;
 
   void make(const Move &move);
   void undo();
+  // passes the move to the opponent without moving any piece
+  void make_null();
+  void undo_null();
+  bool last_move_was_null() const;
+
+  BoardSnapshot get_snapshot() const;
+  // the position after the move, without changing the board
+  BoardSnapshot make_copy(const Move &move) const;
+  // continues the game from a snapshot returned by make_copy
+  void make(const BoardSnapshot &snapshot);
+  // takes back the last move by restoring the position from before it
+  void undo(const BoardSnapshot &parent);
 
   bool is_in_check(Color color) const;
-
-  std::vector<Move> get_pseudo_legal_moves(MoveCategory move_category) const;
+  // the pieces of both sides that attack the square with the given occupancy
+  uint64_t attackers_to(int square, uint64_t occupied) const;
+  // the material the player to move wins or loses with the move
+  // if both sides keep capturing on its end square, least valuable first
+  int see(const Move &move) const;
+  // whether the move leaves the opponent in check, without making it
+  bool gives_check(const Move &move) const;
+  // whether the move is one of the pseudo-legal moves in the position,
+  // for moves that come from other positions such as hash and killer moves
+  bool is_pseudo_legal(const Move &move) const;
+  // whether a pseudo-legal move doesn't leave the player's king in check
+  bool is_legal(const Move &move) const;
+
+  MoveList get_pseudo_legal_moves(MoveCategory move_category) const;
+  void get_pseudo_legal_moves(MoveCategory move_category,
+                              MoveList &moves) const;
+  MoveList get_legal_moves(MoveCategory move_category) const;
+  void get_legal_moves(MoveCategory move_category, MoveList &moves) const;
 
   bool is_draw() const;
   bool is_insufficient_material() const;
@@ -66,49 +166,89 @@ public:
 private:
   std::array<std::array<uint64_t, 6>, 2> piece_bbs;
   std::array<uint64_t, 2> side_bbs;
-  std::stack<PosData> history;
-  std::stack<Move> move_history;
-  const Masks masks;
-
-  std::optional<Piece> get_piece_to_be_captured(const Move &move) const;
-  std::array<int, 2>
-  updated_material(const Move &move, std::optional<Piece> captured_piece) const;
-  std::array<int, 2> updated_psqt(const Move &move,
-                                  std::optional<Piece> captured_piece) const;
-
-  std::optional<PieceType> piece_type(int pos, Color color) const;
-  std::array<Castling, 2> updated_castling_rights(const Move &move) const;
-  int get_castling_rook(const Move &move, Color color) const;
-
-  void gen_moves_piece(PieceType piece, int start, MoveCategory move_category,
-                       std::vector<Move> &moves) const;
-  void gen_all_moves_piece(PieceType piece, MoveCategory move_category,
-                           std::vector<Move> &moves) const;
-
-  std::vector<Move> gen_knight_moves(int start) const;
-  void gen_pawn_moves(int start, MoveCategory move_category,
-                      std::vector<Move> &moves) const;
-
-  void gen_king_moves(int start, MoveCategory move_category,
-                      std::vector<Move> &moves) const;
+  // the type of the piece on each square, or EMPTY_SQUARE,
+  // so that a square can be looked up without scanning the bitboards
+  std::array<uint8_t, 64> mailbox;
+  std::array<PosData, HISTORY_CAPACITY> history;
+  // the index of the current position in the history
+  int ply;
+  mutable long attack_computations;
+
+  PosData updated_pos_data(const Move &move) const;
+  static void move_pieces(const Move &move, const PosData &pos_data,
+                          int en_passant_square,
+                          std::array<std::array<uint64_t, 6>, 2> &piece_bbs,
+                          std::array<uint64_t, 2> &side_bbs,
+                          std::array<uint8_t, 64> &mailbox);
+  void compute_check_info() const;
+  void compute_check_squares() const;
+  static int get_castling_rook(const Move &move, Color color);
+
+  template <Color player, MoveCategory move_category>
+  void gen_legal_moves(MoveList &moves) const;
+  template <Color player, MoveCategory move_category>
+  void gen_pseudo_legal_moves(MoveList &moves) const;
+  template <Color player, MoveCategory move_category>
+  uint64_t get_category_targets() const;
+  template <Color player, MoveCategory move_category, PieceType piece>
+  void gen_piece_moves(uint64_t target, uint64_t pinned, int king_pos,
+                       MoveList &moves) const;
+
+  template <Color player, MoveCategory move_category>
+  void gen_pawn_moves(uint64_t pawns, uint64_t target, MoveList &moves) const;
+  template <Color player>
+  void gen_en_passant_moves(bool only_legal, MoveList &moves) const;
+  bool is_legal_en_passant(int start, int end) const;
+
+  template <Color player, MoveCategory move_category>
+  void gen_king_moves(int start, MoveList &moves) const;
+  template <Color player, MoveCategory move_category>
+  void gen_legal_king_moves(int start, MoveList &moves) const;
   uint64_t get_castling_check_not_allowed_bb(int start, bool kingside) const;
   uint64_t get_castling_pieces_not_allowed_bb(int start, bool kingside) const;
-  uint64_t gen_castling_moves_bb(int start) const;
+  template <Color player> uint64_t gen_castling_moves_bb(int start) const;
 
   uint64_t gen_rook_attacks(int start, uint64_t occupied) const;
   uint64_t gen_bishop_attacks(int start, uint64_t occupied) const;
   uint64_t gen_queen_attacks(int start, uint64_t occupied) const;
 
-  uint64_t gen_file_attacks(int start, uint64_t occupied) const;
-  uint64_t gen_rank_attacks(int start, uint64_t occupied) const;
-  uint64_t gen_diag_attacks(int start, uint64_t occupied) const;
-  uint64_t gen_antidiag_attacks(int start, uint64_t occupied) const;
-  uint64_t gen_sliding_attacks(int start, uint64_t occupied,
-                               uint64_t mask) const;
-
   uint64_t get_attacking_bb(Color color) const;
   bool is_attacking(int pos, Color color) const;
+  uint64_t get_attackers(int pos, Color color, uint64_t occupied) const;
+  uint64_t find_blockers(int king_pos, Color king_color, Color color) const;
 
   bool is_lone_king(Color color) const;
   bool is_endgame() const;
 };
+
+// Makes and takes back the moves from one position in the given mode.
+// In copy-make mode the position is copied once,
+// and every move is taken back by restoring the copy
+template <MakeMode make_mode> class MoveMaker {
+public:
+  explicit MoveMaker(Board &board) : board(board) {
+    if constexpr (make_mode == COPY_MAKE) {
+      parent = board.get_snapshot();
+    }
+  }
+
+  void make(const Move &move) {
+    if constexpr (make_mode == COPY_MAKE) {
+      board.make(board.make_copy(move));
+    } else {
+      board.make(move);
+    }
+  }
+
+  void undo() {
+    if constexpr (make_mode == COPY_MAKE) {
+      board.undo(parent);
+    } else {
+      board.undo();
+    }
+  }
+
+private:
+  Board &board;
+  BoardSnapshot parent;
+};
@@ -14,6 +14,195 @@ struct Masks {
   std::array<uint64_t, 8> ranks;
   std::array<uint64_t, 15> diags;
   std::array<uint64_t, 15> antidiags;
+  // the squares strictly between two squares on the same line, otherwise 0
+  std::array<std::array<uint64_t, 64>, 64> between;
+  // the whole rank, file or diagonal through two squares, otherwise 0
+  std::array<std::array<uint64_t, 64>, 64> lines;
 };
 
-Masks create_masks();
+namespace masks {
+
+constexpr std::array<uint64_t, 64> square_masks() {
+  std::array<uint64_t, 64> masks{};
+  for (int i = 0; i < 64; i++) {
+    masks[i] = (uint64_t)1 << i;
+  }
+  return masks;
+}
+
+constexpr std::array<uint64_t, 8> rank_masks() {
+  std::array<uint64_t, 8> masks{};
+  for (int i = 0; i < 64; i++) {
+    int rank = i / 8;
+    masks[rank] |= (uint64_t)1 << i;
+  }
+  return masks;
+}
+
+constexpr std::array<uint64_t, 8> file_masks() {
+  std::array<uint64_t, 8> masks{};
+  for (int i = 0; i < 64; i++) {
+    int file = i % 8;
+    masks[file] |= (uint64_t)1 << i;
+  }
+  return masks;
+}
+
+constexpr std::array<uint64_t, 15> diag_masks() {
+  std::array<uint64_t, 15> masks{};
+  for (int i = 0; i < 64; i++) {
+    int file = i % 8;
+    int rank = i / 8;
+    int diag = file + rank;
+    masks[diag] |= (uint64_t)1 << i;
+  }
+  return masks;
+}
+
+constexpr std::array<uint64_t, 15> antidiag_masks() {
+  std::array<uint64_t, 15> masks{};
+  for (int i = 0; i < 64; i++) {
+    int file = i % 8;
+    int rank = i / 8;
+    int diag = file - rank + 7;
+    masks[diag] |= (uint64_t)1 << i;
+  }
+  return masks;
+}
+
+constexpr std::array<uint64_t, 8> files = file_masks();
+constexpr std::array<uint64_t, 8> ranks = rank_masks();
+
+constexpr uint64_t king_moves_mask(uint64_t king) {
+  uint64_t bb = 0;
+  bb |= (king & ~files[0]) >> 1;
+  bb |= (king & ~files[7]) << 1;
+  bb |= (king & ~ranks[0]) >> 8;
+  bb |= (king & ~ranks[7]) << 8;
+
+  bb |= (king & ~(files[0] | ranks[0])) >> 9;
+  bb |= (king & ~(files[0] | ranks[7])) << 7;
+  bb |= (king & ~(files[7] | ranks[0])) >> 7;
+  bb |= (king & ~(files[7] | ranks[7])) << 9;
+
+  return bb;
+}
+
+constexpr uint64_t knight_moves_mask(uint64_t knight) {
+  uint64_t bb = 0;
+
+  bb |= (knight & ~(files[0] | ranks[0] | ranks[1])) >> 17;
+  bb |= (knight & ~(files[0] | ranks[7] | ranks[6])) << 15;
+  bb |= (knight & ~(files[0] | files[1] | ranks[0])) >> 10;
+  bb |= (knight & ~(files[0] | files[1] | ranks[7])) << 6;
+
+  bb |= (knight & ~(files[7] | ranks[0] | ranks[1])) >> 15;
+  bb |= (knight & ~(files[7] | ranks[7] | ranks[6])) << 17;
+  bb |= (knight & ~(files[7] | files[6] | ranks[0])) >> 6;
+  bb |= (knight & ~(files[7] | files[6] | ranks[7])) << 10;
+
+  return bb;
+}
+
+constexpr uint64_t white_pawn_moves_one_mask(uint64_t pawn) {
+  return (pawn & ~ranks[0]) >> 8;
+}
+
+constexpr uint64_t white_pawn_moves_two_mask(uint64_t pawn) {
+  return (pawn & ranks[6]) >> 16;
+}
+
+constexpr uint64_t black_pawn_moves_one_mask(uint64_t pawn) {
+  return (pawn & ~ranks[7]) << 8;
+}
+
+constexpr uint64_t black_pawn_moves_two_mask(uint64_t pawn) {
+  return (pawn & ranks[1]) << 16;
+}
+
+constexpr uint64_t white_pawn_captures_mask(uint64_t pawn) {
+  uint64_t bb = 0;
+  bb |= (pawn & ~(ranks[0] | files[7])) >> 7;
+  bb |= (pawn & ~(ranks[0] | files[0])) >> 9;
+  return bb;
+}
+
+constexpr uint64_t black_pawn_captures_mask(uint64_t pawn) {
+  uint64_t bb = 0;
+  bb |= (pawn & ~(ranks[7] | files[0])) << 7;
+  bb |= (pawn & ~(ranks[7] | files[7])) << 9;
+  return bb;
+}
+
+constexpr int sign(int n) { return (n > 0) - (n < 0); }
+
+constexpr bool is_aligned(int from, int to) {
+  const int file_diff = to % 8 - from % 8;
+  const int rank_diff = to / 8 - from / 8;
+  return from != to && (file_diff == 0 || rank_diff == 0 ||
+                        file_diff == rank_diff || file_diff == -rank_diff);
+}
+
+constexpr uint64_t between_mask(int from, int to) {
+  if (!is_aligned(from, to)) {
+    return 0;
+  }
+  const int step = sign(to / 8 - from / 8) * 8 + sign(to % 8 - from % 8);
+  uint64_t bb = 0;
+  for (int i = from + step; i != to; i += step) {
+    bb |= (uint64_t)1 << i;
+  }
+  return bb;
+}
+
+constexpr uint64_t line_mask(int from, int to, const Masks &masks) {
+  if (!is_aligned(from, to)) {
+    return 0;
+  }
+  const int from_file = from % 8;
+  const int from_rank = from / 8;
+  const int to_file = to % 8;
+  const int to_rank = to / 8;
+  if (from_file == to_file) {
+    return masks.files[from_file];
+  }
+  if (from_rank == to_rank) {
+    return masks.ranks[from_rank];
+  }
+  if (from_file + from_rank == to_file + to_rank) {
+    return masks.diags[from_file + from_rank];
+  }
+  return masks.antidiags[from_file - from_rank + 7];
+}
+
+constexpr Masks create_masks() {
+  Masks masks{};
+  masks.squares = square_masks();
+  for (int i = 0; i < 64; i++) {
+    uint64_t bb_square = masks.squares[i];
+    masks.knight_moves[i] = knight_moves_mask(bb_square);
+    masks.king_moves[i] = king_moves_mask(bb_square);
+    masks.pawn_moves_one[0][i] = white_pawn_moves_one_mask(bb_square);
+    masks.pawn_moves_one[1][i] = black_pawn_moves_one_mask(bb_square);
+    masks.pawn_moves_two[0][i] = white_pawn_moves_two_mask(bb_square);
+    masks.pawn_moves_two[1][i] = black_pawn_moves_two_mask(bb_square);
+    masks.pawn_captures[0][i] = white_pawn_captures_mask(bb_square);
+    masks.pawn_captures[1][i] = black_pawn_captures_mask(bb_square);
+  }
+  masks.files = files;
+  masks.ranks = ranks;
+  masks.diags = diag_masks();
+  masks.antidiags = antidiag_masks();
+  for (int from = 0; from < 64; from++) {
+    for (int to = 0; to < 64; to++) {
+      masks.between[from][to] = between_mask(from, to);
+      masks.lines[from][to] = line_mask(from, to, masks);
+    }
+  }
+  return masks;
+}
+
+} // namespace masks
+
+// the tables are generated at compile time and shared by all boards
+alignas(64) inline constexpr Masks MASKS = masks::create_masks();
@@ -1,324 +1,701 @@
 #include "board.hpp"
+#include "board/attacks.hpp"
 #include "board/bits.hpp"
 #include "defs.hpp"
+#include "evaluation/evaluation.hpp"
 #include "move.hpp"
 #include "utils.hpp"
+#include <algorithm>
 #include <cassert>
 
+static constexpr std::array<PieceType, 4> PROMOTION_PIECES = {QUEEN, ROOK,
+                                                              BISHOP, KNIGHT};
+
+static constexpr Color opposite(Color color) {
+  return color == WHITE ? BLACK : WHITE;
+}
+
+// the king can't castle out of check either,
+// but that is known from the checkers of the position
 uint64_t Board::get_castling_check_not_allowed_bb(int start,
                                                   bool kingside) const {
-  uint64_t bb = masks.squares.at(start);
-  return bb |= kingside
-                   ? masks.squares.at(start + 1) | masks.squares.at(start + 2)
-                   : masks.squares.at(start - 1) | masks.squares.at(start - 2);
+  return kingside ? MASKS.squares.at(start + 1) | MASKS.squares.at(start + 2)
+                  : MASKS.squares.at(start - 1) | MASKS.squares.at(start - 2);
 }
 
 uint64_t Board::get_castling_pieces_not_allowed_bb(int start,
                                                    bool kingside) const {
-  return kingside ? masks.squares.at(start + 1) | masks.squares.at(start + 2)
-                  : masks.squares.at(start - 1) | masks.squares.at(start - 2) |
-                        masks.squares.at(start - 3);
+  return kingside ? MASKS.squares.at(start + 1) | MASKS.squares.at(start + 2)
+                  : MASKS.squares.at(start - 1) | MASKS.squares.at(start - 2) |
+                        MASKS.squares.at(start - 3);
 }
 
+template <Color player>
 uint64_t Board::gen_castling_moves_bb(int start) const {
   uint64_t castling = 0;
 
-  int king_initial = get_player_to_move() == WHITE ? 60 : 4;
-  if (start != king_initial) {
+  constexpr int king_initial = player == WHITE ? e1 : e8;
+  if (start != king_initial || get_checkers() != 0) {
     return 0;
   }
 
-  if (is_in_check(get_player_to_move())) {
-    return 0;
+  const uint8_t castling_rights = history[ply].castling_rights;
+  const uint64_t pieces_bb = get_occupied() & ~piece_bbs[player][KING];
+
+  // the squares the king passes are only checked for attacks
+  // when the squares between the king and rook are empty,
+  // and the opponent's attacks are computed at most once for both sides
+  uint64_t attacked = 0;
+  bool attacked_computed = false;
+  for (const bool kingside : {true, false}) {
+    if ((castling_rights & castling_right(player, kingside)) == 0 ||
+        (get_castling_pieces_not_allowed_bb(start, kingside) & pieces_bb) !=
+            0) {
+      continue;
+    }
+    if (!attacked_computed) {
+      attacked = get_attacking_bb(opposite(player));
+      attacked_computed = true;
+    }
+    if ((get_castling_check_not_allowed_bb(start, kingside) & attacked) ==
+        0) {
+      castling |= MASKS.squares.at(kingside ? start + 2 : start - 2);
+    }
   }
 
-  Castling castling_rights =
-      history.top().castling_rights.at(get_player_to_move());
+  return castling;
+}
 
-  uint64_t attacked_bb =
-      castling_rights.kingside || castling_rights.queenside
-          ? get_attacking_bb(get_opposite_color(get_player_to_move()))
-          : 0;
+template <Color player, MoveCategory move_category>
+uint64_t Board::get_category_targets() const {
+  if constexpr (move_category == TACTICAL) {
+    return side_bbs[opposite(player)];
+  } else if constexpr (move_category == QUIET) {
+    return ~get_occupied();
+  } else {
+    return ~side_bbs[player];
+  }
+}
 
-  uint64_t pieces_bb = (side_bbs.at(get_player_to_move()) &
-                        ~piece_bbs.at(get_player_to_move()).at(KING)) |
-                       side_bbs.at(get_opposite_color(get_player_to_move()));
+template <Color player, MoveCategory move_category>
+void Board::gen_king_moves(int start, MoveList &moves) const {
+  const uint64_t normal =
+      MASKS.king_moves[start] & get_category_targets<player, move_category>();
+  for (const int end : bits::SetBits(normal)) {
+    moves.push_back(Move(start, end));
+  }
 
-  if (castling_rights.kingside) {
-    uint64_t no_check_bb = get_castling_check_not_allowed_bb(start, true);
-    uint64_t no_pieces_bb = get_castling_pieces_not_allowed_bb(start, true);
-    if (((no_check_bb & attacked_bb) | (no_pieces_bb & pieces_bb)) == 0) {
-      castling |= masks.squares.at(start + 2);
+  if constexpr (move_category != TACTICAL) {
+    for (const int end : bits::SetBits(gen_castling_moves_bb<player>(start))) {
+      moves.push_back(Move(start, end, CASTLING));
     }
   }
+}
 
-  if (castling_rights.queenside) {
-    uint64_t no_check_bb = get_castling_check_not_allowed_bb(start, false);
-    uint64_t no_pieces_bb = get_castling_pieces_not_allowed_bb(start, false);
-    if (((no_check_bb & attacked_bb) | (no_pieces_bb & pieces_bb)) == 0) {
-      castling |= masks.squares.at(start - 2);
+template <Color player, MoveCategory move_category>
+void Board::gen_legal_king_moves(int start, MoveList &moves) const {
+  // the king can't escape a sliding piece by moving along its line,
+  // so the king itself must not block the attack
+  const uint64_t occupied = get_occupied() & ~MASKS.squares[start];
+
+  const uint64_t normal =
+      MASKS.king_moves[start] & get_category_targets<player, move_category>();
+  for (const int end : bits::SetBits(normal)) {
+    if (get_attackers(end, opposite(player), occupied) == 0) {
+      moves.push_back(Move(start, end));
     }
   }
 
-  return castling;
+  if constexpr (move_category != TACTICAL) {
+    for (const int end : bits::SetBits(gen_castling_moves_bb<player>(start))) {
+      moves.push_back(Move(start, end, CASTLING));
+    }
+  }
+}
+
+template <Color player> static constexpr uint64_t push(uint64_t bb) {
+  return player == WHITE ? bb >> 8 : bb << 8;
+}
+
+// the pawns capturing towards the a-file and towards the h-file
+template <Color player> static constexpr uint64_t capture_west(uint64_t bb) {
+  bb &= ~MASKS.files[0];
+  return player == WHITE ? bb >> 9 : bb << 7;
 }
 
-void Board::gen_king_moves(int start, MoveCategory move_category,
-                           std::vector<Move> &moves) const {
-  uint64_t normal = masks.king_moves.at(start);
-  normal &= move_category == TACTICAL
-                ? side_bbs.at(get_opposite_color(get_player_to_move()))
-                : ~side_bbs.at(get_player_to_move());
+template <Color player> static constexpr uint64_t capture_east(uint64_t bb) {
+  bb &= ~MASKS.files[7];
+  return player == WHITE ? bb >> 7 : bb << 9;
+}
 
-  std::optional<int> end_pos = bits::popLSB(normal);
-  while (end_pos.has_value()) {
-    Move move(start, end_pos.value());
-    moves.push_back(move);
-    end_pos = bits::popLSB(normal);
+// adds a move to every square in ends from the square delta behind it
+static void add_pawn_moves(uint64_t ends, int delta, MoveType move_type,
+                           MoveList &moves) {
+  for (const int end : bits::SetBits(ends)) {
+    moves.push_back(Move(end + delta, end, move_type));
   }
+}
 
-  if (move_category == ALL) {
-    uint64_t castling = gen_castling_moves_bb(start);
-    end_pos = bits::popLSB(castling);
-    while (end_pos.has_value()) {
-      Move move(start, end_pos.value(), CASTLING);
-      moves.push_back(move);
-      end_pos = bits::popLSB(castling);
+static void add_promotions(uint64_t ends, int delta, MoveList &moves) {
+  for (const int end : bits::SetBits(ends)) {
+    for (PieceType p : PROMOTION_PIECES) {
+      moves.push_back(Move(end + delta, end, p));
     }
   }
 }
 
-void Board::gen_pawn_moves(int start, MoveCategory move_category,
-                           std::vector<Move> &moves) const {
-  uint64_t pawn = masks.squares.at(start);
-  uint64_t all_pieces = side_bbs.at(WHITE) | side_bbs.at(BLACK);
-  uint64_t all_pieces_one_rank_forward =
-      get_player_to_move() == WHITE ? all_pieces >> 8 : all_pieces << 8;
-
-  uint64_t move_one =
-      masks.pawn_moves_one.at(get_player_to_move()).at(start) & ~all_pieces;
-  uint64_t move_two = masks.pawn_moves_two.at(get_player_to_move()).at(start) &
-                      ~(all_pieces | all_pieces_one_rank_forward);
-
-  uint64_t captures = masks.pawn_captures.at(get_player_to_move()).at(start) &
-                      ~side_bbs.at(get_player_to_move());
-  uint64_t normal_captures =
-      captures & side_bbs.at(get_opposite_color(get_player_to_move()));
-
-  uint64_t en_passant_captures =
-      get_en_passant_square().has_value()
-          ? captures & masks.squares.at(get_en_passant_square().value())
-          : 0;
-
-  std::optional<int> end_pos = bits::popLSB(move_one);
-  while (end_pos.has_value()) {
-    bool is_promotion = end_pos.value() < 8 || end_pos.value() > 55;
-    if (is_promotion) {
-      std::array<PieceType, 4> promotion_pieces = {
-          QUEEN,
-          ROOK,
-          BISHOP,
-          KNIGHT,
-      };
-      for (PieceType p : promotion_pieces) {
-        Move move(start, end_pos.value(), p);
-        moves.push_back(move);
-      }
-    } else if (move_category == ALL) {
-      Move move(start, end_pos.value());
-      moves.push_back(move);
-    }
-    end_pos = bits::popLSB(move_one);
-  }
-
-  end_pos = bits::popLSB(normal_captures);
-  while (end_pos.has_value()) {
-    bool is_promotion = end_pos.value() < 8 || end_pos.value() > 55;
-    if (is_promotion) {
-      std::array<PieceType, 4> promotion_pieces = {
-          QUEEN,
-          ROOK,
-          BISHOP,
-          KNIGHT,
-      };
-      for (PieceType p : promotion_pieces) {
-        Move move(start, end_pos.value(), p);
-        moves.push_back(move);
-      }
-    } else {
-      Move move(start, end_pos.value());
-      moves.push_back(move);
-    }
-    end_pos = bits::popLSB(normal_captures);
+template <Color player, MoveCategory move_category>
+void Board::gen_pawn_moves(uint64_t pawns, uint64_t target,
+                           MoveList &moves) const {
+  // promotions count as tactical moves, other pawn pushes as quiet moves
+  constexpr bool gen_tactical = move_category != QUIET;
+  constexpr bool gen_quiet = move_category != TACTICAL;
+  constexpr uint64_t promotion_rank = MASKS.ranks[player == WHITE ? 0 : 7];
+  // a pawn that has moved one square from its starting rank
+  constexpr uint64_t double_push_rank = MASKS.ranks[player == WHITE ? 5 : 2];
+  // the offsets from the end square back to the start square
+  constexpr int forward = player == WHITE ? 8 : -8;
+  constexpr int west = player == WHITE ? 9 : -7;
+  constexpr int east = player == WHITE ? 7 : -9;
+
+  const uint64_t empty = ~get_occupied();
+  const uint64_t move_one = push<player>(pawns) & empty;
+
+  if constexpr (gen_tactical) {
+    add_promotions(move_one & target & promotion_rank, forward, moves);
+
+    const uint64_t enemies = side_bbs[opposite(player)] & target;
+    const uint64_t captures_west = capture_west<player>(pawns) & enemies;
+    const uint64_t captures_east = capture_east<player>(pawns) & enemies;
+    add_promotions(captures_west & promotion_rank, west, moves);
+    add_promotions(captures_east & promotion_rank, east, moves);
+    add_pawn_moves(captures_west & ~promotion_rank, west, NORMAL, moves);
+    add_pawn_moves(captures_east & ~promotion_rank, east, NORMAL, moves);
+  }
+
+  if constexpr (gen_quiet) {
+    const uint64_t move_two =
+        push<player>(move_one & double_push_rank) & empty & target;
+    add_pawn_moves(move_one & target & ~promotion_rank, forward, NORMAL,
+                   moves);
+    add_pawn_moves(move_two, 2 * forward, PAWN_TWO_SQUARES_FORWARD, moves);
   }
+}
 
-  if (move_category == ALL) {
-    end_pos = bits::popLSB(move_two);
-    while (end_pos.has_value()) {
-      Move move(start, end_pos.value(), PAWN_TWO_SQUARES_FORWARD);
-      moves.push_back(move);
-      end_pos = bits::popLSB(move_two);
+template <Color player>
+void Board::gen_en_passant_moves(bool only_legal, MoveList &moves) const {
+  const int8_t en_passant_square = history[ply].en_passant_square;
+  if (en_passant_square == NO_SQUARE) {
+    return;
+  }
+  // the pawns that could capture an opponent pawn on the square
+  const uint64_t pawns =
+      piece_bbs[player][PAWN] &
+      MASKS.pawn_captures[opposite(player)][en_passant_square];
+  for (const int start : bits::SetBits(pawns)) {
+    if (!only_legal || is_legal_en_passant(start, en_passant_square)) {
+      moves.push_back(Move(start, en_passant_square, EN_PASSANT));
     }
   }
+}
 
-  end_pos = bits::popLSB(en_passant_captures);
-  while (end_pos.has_value()) {
-    Move move(start, end_pos.value(), EN_PASSANT);
-    moves.push_back(move);
-    end_pos = bits::popLSB(en_passant_captures);
+uint64_t Board::gen_rook_attacks(int start, uint64_t occupied) const {
+  return attacks::rook(start, occupied);
+}
+
+uint64_t Board::gen_bishop_attacks(int start, uint64_t occupied) const {
+  return attacks::bishop(start, occupied);
+}
+
+uint64_t Board::gen_queen_attacks(int start, uint64_t occupied) const {
+  return attacks::queen(start, occupied);
+}
+
+template <PieceType piece>
+static uint64_t piece_attacks(int start, uint64_t occupied) {
+  if constexpr (piece == KNIGHT) {
+    return MASKS.knight_moves[start];
+  } else if constexpr (piece == BISHOP) {
+    return attacks::bishop(start, occupied);
+  } else if constexpr (piece == ROOK) {
+    return attacks::rook(start, occupied);
+  } else {
+    return attacks::queen(start, occupied);
+  }
+}
+
+template <Color player, MoveCategory move_category, PieceType piece>
+void Board::gen_piece_moves(uint64_t target, uint64_t pinned, int king_pos,
+                            MoveList &moves) const {
+  const uint64_t occupied = get_occupied();
+  target &= get_category_targets<player, move_category>();
+  for (const int start : bits::SetBits(piece_bbs[player][piece])) {
+    uint64_t moves_bb = piece_attacks<piece>(start, occupied) & target;
+    // a pinned piece can only move along the line of the pin
+    if (bits::get(pinned, start) == 1) {
+      moves_bb &= MASKS.lines[king_pos][start];
+    }
+    for (const int end : bits::SetBits(moves_bb)) {
+      moves.push_back(Move(start, end));
+    }
   }
 }
 
-uint64_t Board::gen_sliding_attacks(int start, uint64_t occupied,
-                                    uint64_t mask) const {
-  uint64_t forward = 0;
-  uint64_t reverse = 0;
-  forward = occupied & mask;
-  reverse = bits::reverse(forward);
-  forward -= 2 * masks.squares.at(start);
-  reverse -= 2 * bits::reverse(masks.squares.at(start));
-  forward ^= bits::reverse(reverse);
-  forward &= mask;
-  return forward;
+template <Color player, MoveCategory move_category>
+void Board::gen_pseudo_legal_moves(MoveList &moves) const {
+  moves.clear();
+  gen_pawn_moves<player, move_category>(piece_bbs[player][PAWN], ALL_SQUARES,
+                                        moves);
+  if constexpr (move_category != QUIET) {
+    gen_en_passant_moves<player>(false, moves);
+  }
+  gen_piece_moves<player, move_category, KNIGHT>(ALL_SQUARES, 0, 0, moves);
+  gen_piece_moves<player, move_category, BISHOP>(ALL_SQUARES, 0, 0, moves);
+  gen_piece_moves<player, move_category, ROOK>(ALL_SQUARES, 0, 0, moves);
+  gen_piece_moves<player, move_category, QUEEN>(ALL_SQUARES, 0, 0, moves);
+  for (const int start : bits::SetBits(piece_bbs[player][KING])) {
+    gen_king_moves<player, move_category>(start, moves);
+  }
 }
 
-uint64_t Board::gen_file_attacks(int start, uint64_t occupied) const {
-  int file = start % 8;
-  return gen_sliding_attacks(start, occupied, masks.files.at(file));
+template <Color player, MoveCategory move_category>
+void Board::gen_legal_moves(MoveList &moves) const {
+  moves.clear();
+  const int king_pos = bits::lsb(piece_bbs[player][KING]);
+  const uint64_t checkers = get_checkers();
+  const uint64_t pinned = get_pinned();
+
+  // when in check by one piece, the other pieces can only capture it
+  // or block the line between it and the king,
+  // and when in double check only the king can move
+  uint64_t target = ALL_SQUARES;
+  if (checkers != 0) {
+    const int checker_pos = bits::lsb(checkers);
+    target = bits::clear_lsb(checkers) == 0
+                 ? checkers | MASKS.between[king_pos][checker_pos]
+                 : 0;
+  }
+
+  if (target != 0) {
+    const uint64_t pawns = piece_bbs[player][PAWN];
+    gen_pawn_moves<player, move_category>(pawns & ~pinned, target, moves);
+    // a pinned pawn can only move along the line of the pin
+    for (const int start : bits::SetBits(pawns & pinned)) {
+      gen_pawn_moves<player, move_category>(
+          MASKS.squares[start], target & MASKS.lines[king_pos][start], moves);
+    }
+    if constexpr (move_category != QUIET) {
+      gen_en_passant_moves<player>(true, moves);
+    }
+    gen_piece_moves<player, move_category, KNIGHT>(target, pinned, king_pos,
+                                                   moves);
+    gen_piece_moves<player, move_category, BISHOP>(target, pinned, king_pos,
+                                                   moves);
+    gen_piece_moves<player, move_category, ROOK>(target, pinned, king_pos,
+                                                 moves);
+    gen_piece_moves<player, move_category, QUEEN>(target, pinned, king_pos,
+                                                  moves);
+  }
+
+  gen_legal_king_moves<player, move_category>(king_pos, moves);
 }
 
-uint64_t Board::gen_rank_attacks(int start, uint64_t occupied) const {
-  int rank = start / 8;
-  return gen_sliding_attacks(start, occupied, masks.ranks.at(rank));
+MoveList Board::get_pseudo_legal_moves(MoveCategory move_category) const {
+  MoveList moves;
+  get_pseudo_legal_moves(move_category, moves);
+  return moves;
 }
 
-uint64_t Board::gen_diag_attacks(int start, uint64_t occupied) const {
-  int file = start % 8;
-  int rank = start / 8;
-  int diag = file + rank;
-  return gen_sliding_attacks(start, occupied, masks.diags.at(diag));
+// the side to move and the category are only branched on here,
+// so that they are constants in the generators
+void Board::get_pseudo_legal_moves(MoveCategory move_category,
+                                   MoveList &moves) const {
+  const bool white = get_player_to_move() == WHITE;
+  switch (move_category) {
+  case ALL:
+    return white ? gen_pseudo_legal_moves<WHITE, ALL>(moves)
+                 : gen_pseudo_legal_moves<BLACK, ALL>(moves);
+  case TACTICAL:
+    return white ? gen_pseudo_legal_moves<WHITE, TACTICAL>(moves)
+                 : gen_pseudo_legal_moves<BLACK, TACTICAL>(moves);
+  case QUIET:
+    return white ? gen_pseudo_legal_moves<WHITE, QUIET>(moves)
+                 : gen_pseudo_legal_moves<BLACK, QUIET>(moves);
+  }
 }
 
-uint64_t Board::gen_antidiag_attacks(int start, uint64_t occupied) const {
-  int file = start % 8;
-  int rank = start / 8;
-  int diag = file - rank + 7;
-  return gen_sliding_attacks(start, occupied, masks.antidiags.at(diag));
+MoveList Board::get_legal_moves(MoveCategory move_category) const {
+  MoveList moves;
+  get_legal_moves(move_category, moves);
+  return moves;
 }
 
-uint64_t Board::gen_rook_attacks(int start, uint64_t occupied) const {
-  return gen_file_attacks(start, occupied) | gen_rank_attacks(start, occupied);
+void Board::get_legal_moves(MoveCategory move_category,
+                            MoveList &moves) const {
+  const bool white = get_player_to_move() == WHITE;
+  switch (move_category) {
+  case ALL:
+    return white ? gen_legal_moves<WHITE, ALL>(moves)
+                 : gen_legal_moves<BLACK, ALL>(moves);
+  case TACTICAL:
+    return white ? gen_legal_moves<WHITE, TACTICAL>(moves)
+                 : gen_legal_moves<BLACK, TACTICAL>(moves);
+  case QUIET:
+    return white ? gen_legal_moves<WHITE, QUIET>(moves)
+                 : gen_legal_moves<BLACK, QUIET>(moves);
+  }
 }
 
-uint64_t Board::gen_bishop_attacks(int start, uint64_t occupied) const {
-  return gen_diag_attacks(start, occupied) |
-         gen_antidiag_attacks(start, occupied);
+uint64_t Board::get_attackers(int pos, Color color, uint64_t occupied) const {
+  attack_computations++;
+  const std::array<uint64_t, 6> &pieces_bb = piece_bbs.at(color);
+  const uint64_t rooks_queens = pieces_bb.at(ROOK) | pieces_bb.at(QUEEN);
+  const uint64_t bishops_queens = pieces_bb.at(BISHOP) | pieces_bb.at(QUEEN);
+
+  const uint64_t attackers =
+      (MASKS.knight_moves.at(pos) & pieces_bb.at(KNIGHT)) |
+      (MASKS.king_moves.at(pos) & pieces_bb.at(KING)) |
+      (MASKS.pawn_captures.at(get_opposite_color(color)).at(pos) &
+       pieces_bb.at(PAWN)) |
+      (gen_rook_attacks(pos, occupied) & rooks_queens) |
+      (gen_bishop_attacks(pos, occupied) & bishops_queens);
+
+  // pieces that have been removed from the occupancy can't attack
+  return attackers & occupied;
 }
 
-uint64_t Board::gen_queen_attacks(int start, uint64_t occupied) const {
-  return gen_rook_attacks(start, occupied) |
-         gen_bishop_attacks(start, occupied);
+uint64_t Board::attackers_to(int square, uint64_t occupied) const {
+  attack_computations++;
+  const std::array<uint64_t, 6> &white = piece_bbs[WHITE];
+  const std::array<uint64_t, 6> &black = piece_bbs[BLACK];
+  const uint64_t rooks_queens =
+      white[ROOK] | white[QUEEN] | black[ROOK] | black[QUEEN];
+  const uint64_t bishops_queens =
+      white[BISHOP] | white[QUEEN] | black[BISHOP] | black[QUEEN];
+
+  const uint64_t attackers =
+      (MASKS.knight_moves[square] & (white[KNIGHT] | black[KNIGHT])) |
+      (MASKS.king_moves[square] & (white[KING] | black[KING])) |
+      (MASKS.pawn_captures[BLACK][square] & white[PAWN]) |
+      (MASKS.pawn_captures[WHITE][square] & black[PAWN]) |
+      (attacks::rook(square, occupied) & rooks_queens) |
+      (attacks::bishop(square, occupied) & bishops_queens);
+  return attackers & occupied;
 }
 
-void Board::gen_moves_piece(PieceType piece, int start,
-                            MoveCategory move_category,
-                            std::vector<Move> &moves) const {
-  if (piece == KING) {
-    gen_king_moves(start, move_category, moves);
-    return;
+// https://www.chessprogramming.org/SEE_-_The_Swap_Algorithm
+int Board::see(const Move &move) const {
+  const int end = move.get_end();
+  const Color player = get_player_to_move();
+  uint64_t occupied = get_occupied() ^ MASKS.squares[move.get_start()];
+
+  // the material won by each capture in the sequence,
+  // as long as the piece making it isn't captured back
+  std::array<int, 32> gain;
+  int depth = 0;
+  PieceType piece_on_end = (PieceType)mailbox[move.get_start()];
+  if (move.get_move_type() == EN_PASSANT) {
+    gain[0] = PAWN_VALUE;
+    occupied ^= MASKS.squares[end + (player == WHITE ? 8 : -8)];
+  } else {
+    gain[0] = mailbox[end] == EMPTY_SQUARE
+                  ? 0
+                  : get_piece_value((PieceType)mailbox[end]);
   }
-  if (piece == PAWN) {
-    gen_pawn_moves(start, move_category, moves);
-    return;
+  if (move.get_move_type() == PROMOTION) {
+    piece_on_end = move.get_promotion_piece().value();
+    gain[0] += get_piece_value(piece_on_end) - PAWN_VALUE;
   }
 
-  uint64_t occupied = side_bbs.at(WHITE) | side_bbs.at(BLACK);
-  uint64_t attacks = piece == KNIGHT   ? masks.knight_moves.at(start)
-                     : piece == BISHOP ? gen_bishop_attacks(start, occupied)
-                     : piece == ROOK   ? gen_rook_attacks(start, occupied)
-                                       : gen_queen_attacks(start, occupied);
-  uint64_t moves_bb =
-      move_category == TACTICAL
-          ? attacks & side_bbs.at(get_opposite_color(get_player_to_move()))
-          : attacks &= ~side_bbs.at(get_player_to_move());
+  const uint64_t rooks_queens =
+      piece_bbs[WHITE][ROOK] | piece_bbs[WHITE][QUEEN] |
+      piece_bbs[BLACK][ROOK] | piece_bbs[BLACK][QUEEN];
+  const uint64_t bishops_queens =
+      piece_bbs[WHITE][BISHOP] | piece_bbs[WHITE][QUEEN] |
+      piece_bbs[BLACK][BISHOP] | piece_bbs[BLACK][QUEEN];
+  uint64_t attackers = attackers_to(end, occupied);
+  Color side = opposite(player);
+  while (depth + 1 < (int)gain.size()) {
+    const uint64_t side_attackers = attackers & side_bbs[side];
+    if (side_attackers == 0) {
+      break;
+    }
+    int attacker = PAWN;
+    while ((piece_bbs[side][attacker] & side_attackers) == 0) {
+      attacker++;
+    }
+    // the king can't capture a defended piece
+    if (attacker == KING && (attackers & side_bbs[opposite(side)]) != 0) {
+      break;
+    }
+
+    depth++;
+    gain[depth] = get_piece_value(piece_on_end) - gain[depth - 1];
+
+    occupied ^= MASKS.squares[bits::lsb(piece_bbs[side][attacker] &
+                                        side_attackers)];
+    // sliding pieces behind the capturing piece join in
+    if (attacker == PAWN || attacker == BISHOP || attacker == QUEEN) {
+      attackers |= attacks::bishop(end, occupied) & bishops_queens;
+    }
+    if (attacker == ROOK || attacker == QUEEN) {
+      attackers |= attacks::rook(end, occupied) & rooks_queens;
+    }
+    attackers &= occupied;
+    piece_on_end = (PieceType)attacker;
+    side = opposite(side);
+  }
 
-  std::optional<int> end_pos = bits::popLSB(moves_bb);
-  while (end_pos.has_value()) {
-    Move move(start, end_pos.value());
-    moves.push_back(move);
-    end_pos = bits::popLSB(moves_bb);
+  while (depth > 0) {
+    gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+    depth--;
   }
+  return gain[0];
 }
 
-void Board::gen_all_moves_piece(PieceType piece, MoveCategory move_category,
-                                std::vector<Move> &moves) const {
-  uint64_t piece_bb = piece_bbs.at(get_player_to_move()).at(piece);
-  std::optional<int> start_pos = bits::popLSB(piece_bb);
-  while (start_pos.has_value()) {
-    gen_moves_piece(piece, start_pos.value(), move_category, moves);
-    start_pos = bits::popLSB(piece_bb);
+// the pieces of the given color that are the only piece between the king
+// and a sliding piece attacking along that line, which are pinned pieces
+// when the king has the same color and discoverers otherwise
+uint64_t Board::find_blockers(int king_pos, Color king_color,
+                              Color color) const {
+  attack_computations++;
+  const std::array<uint64_t, 6> &opponent_bbs =
+      piece_bbs.at(get_opposite_color(king_color));
+  const uint64_t occupied = get_occupied();
+
+  // sliding pieces that would attack the king if the board was empty
+  const uint64_t snipers =
+      (gen_rook_attacks(king_pos, 0) &
+       (opponent_bbs.at(ROOK) | opponent_bbs.at(QUEEN))) |
+      (gen_bishop_attacks(king_pos, 0) &
+       (opponent_bbs.at(BISHOP) | opponent_bbs.at(QUEEN)));
+
+  uint64_t result = 0;
+  for (const int sniper_pos : bits::SetBits(snipers)) {
+    const uint64_t blockers =
+        MASKS.between.at(king_pos).at(sniper_pos) & occupied;
+    // exactly one piece between the king and the sniper
+    if (blockers != 0 && bits::clear_lsb(blockers) == 0) {
+      result |= blockers & side_bbs.at(color);
+    }
   }
+  return result;
 }
 
-std::vector<Move>
-Board::get_pseudo_legal_moves(MoveCategory move_category) const {
-  std::vector<Move> moves;
-  for (int piece = 0; piece < 6; piece++) {
-    gen_all_moves_piece((PieceType)piece, move_category, moves);
+bool Board::gives_check(const Move &move) const {
+  if (!history[ply].check_squares_computed) {
+    compute_check_squares();
+  }
+  const PosData &pos_data = history[ply];
+  const Color player = get_player_to_move();
+  const std::array<uint64_t, 6> &player_bbs = piece_bbs[player];
+  const int king_pos = bits::lsb(piece_bbs[opposite(player)][KING]);
+  const uint64_t king = MASKS.squares[king_pos];
+  const int start = move.get_start();
+  const int end = move.get_end();
+  const uint64_t start_end = MASKS.squares[start] | MASKS.squares[end];
+
+  // castling and en passant move two pieces, so the attacks on the king
+  // are computed from scratch
+  if (move.get_move_type() == CASTLING) {
+    const int rook_start = get_castling_rook(move, player);
+    const int rook_end = rook_start + (end > start ? -2 : 3);
+    const uint64_t rook_start_end =
+        MASKS.squares[rook_start] | MASKS.squares[rook_end];
+    const uint64_t occupied = get_occupied() ^ start_end ^ rook_start_end;
+    return (attacks::rook(king_pos, occupied) &
+            ((player_bbs[ROOK] ^ rook_start_end) | player_bbs[QUEEN])) != 0 ||
+           (attacks::bishop(king_pos, occupied) &
+            (player_bbs[BISHOP] | player_bbs[QUEEN])) != 0;
+  }
+  if (move.get_move_type() == EN_PASSANT) {
+    const int captured_pos = end + (player == WHITE ? 8 : -8);
+    const uint64_t occupied =
+        get_occupied() ^ start_end ^ MASKS.squares[captured_pos];
+    return (MASKS.pawn_captures[player][end] & king) != 0 ||
+           (attacks::rook(king_pos, occupied) &
+            (player_bbs[ROOK] | player_bbs[QUEEN])) != 0 ||
+           (attacks::bishop(king_pos, occupied) &
+            (player_bbs[BISHOP] | player_bbs[QUEEN])) != 0;
+  }
+
+  // a piece moving off the line between a sliding piece and the king
+  if (bits::get(pos_data.discoverers, start) == 1 &&
+      (MASKS.lines[king_pos][start] & MASKS.squares[end]) == 0) {
+    return true;
+  }
+
+  if (move.get_move_type() == PROMOTION) {
+    // the pawn no longer blocks the promoted piece
+    const uint64_t occupied = get_occupied() ^ MASKS.squares[start];
+    switch (move.get_promotion_piece().value()) {
+    case KNIGHT:
+      return (MASKS.knight_moves[end] & king) != 0;
+    case BISHOP:
+      return (attacks::bishop(end, occupied) & king) != 0;
+    case ROOK:
+      return (attacks::rook(end, occupied) & king) != 0;
+    default:
+      return (attacks::queen(end, occupied) & king) != 0;
+    }
+  }
+
+  // a sliding piece that could reach the king from its end square
+  // would already have been attacking it from its start square
+  // if it moved along that line, so the squares are still valid
+  switch (mailbox[start]) {
+  case PAWN:
+    return (MASKS.pawn_captures[player][end] & king) != 0;
+  case KNIGHT:
+    return (MASKS.knight_moves[end] & king) != 0;
+  case BISHOP:
+    return bits::get(pos_data.bishop_check_squares, end) == 1;
+  case ROOK:
+    return bits::get(pos_data.rook_check_squares, end) == 1;
+  case QUEEN:
+    return bits::get(pos_data.bishop_check_squares |
+                         pos_data.rook_check_squares,
+                     end) == 1;
+  default:
+    return false;
   }
-  return moves;
 }
 
-uint64_t Board::get_attacking_bb(Color color) const {
-  uint64_t attacking = 0;
-
-  std::array<PieceType, 3> non_sliding_pieces = {KING, PAWN, KNIGHT};
-  for (PieceType piece : non_sliding_pieces) {
-    std::array<uint64_t, 64> piece_attacking_bb =
-        piece == KING   ? masks.king_moves
-        : piece == PAWN ? masks.pawn_captures.at(color)
-                        : masks.knight_moves;
-    uint64_t piece_bb = piece_bbs.at(color).at(piece);
-    std::optional<int> start_pos = bits::popLSB(piece_bb);
-    while (start_pos.has_value()) {
-      attacking |= piece_attacking_bb.at(start_pos.value());
-      start_pos = bits::popLSB(piece_bb);
+bool Board::is_pseudo_legal(const Move &move) const {
+  const Color player = get_player_to_move();
+  const int start = move.get_start();
+  const int end = move.get_end();
+  const uint64_t end_bb = MASKS.squares[end];
+  if (bits::get(side_bbs[player], start) == 0 ||
+      (side_bbs[player] & end_bb) != 0) {
+    return false;
+  }
+  const uint64_t occupied = get_occupied();
+  const MoveType move_type = move.get_move_type();
+
+  if (mailbox[start] != PAWN) {
+    if (move_type == CASTLING) {
+      const uint64_t castling = player == WHITE
+                                    ? gen_castling_moves_bb<WHITE>(start)
+                                    : gen_castling_moves_bb<BLACK>(start);
+      return mailbox[start] == KING && (castling & end_bb) != 0;
+    }
+    if (move_type != NORMAL) {
+      return false;
+    }
+    switch (mailbox[start]) {
+    case KNIGHT:
+      return (MASKS.knight_moves[start] & end_bb) != 0;
+    case BISHOP:
+      return (attacks::bishop(start, occupied) & end_bb) != 0;
+    case ROOK:
+      return (attacks::rook(start, occupied) & end_bb) != 0;
+    case QUEEN:
+      return (attacks::queen(start, occupied) & end_bb) != 0;
+    default:
+      return (MASKS.king_moves[start] & end_bb) != 0;
     }
   }
 
-  uint64_t occupied = side_bbs.at(WHITE) | side_bbs.at(BLACK);
-  std::array<PieceType, 3> sliding_pieces = {BISHOP, ROOK, QUEEN};
-  for (PieceType piece : sliding_pieces) {
-    uint64_t piece_bb = piece_bbs.at(color).at(piece);
-    std::optional<int> start_pos = bits::popLSB(piece_bb);
-    while (start_pos.has_value()) {
-      attacking |=
-          piece == BISHOP ? gen_bishop_attacks(start_pos.value(), occupied)
-          : piece == ROOK ? gen_rook_attacks(start_pos.value(), occupied)
-                          : gen_queen_attacks(start_pos.value(), occupied);
+  const uint64_t promotion_rank = MASKS.ranks[player == WHITE ? 0 : 7];
+  switch (move_type) {
+  case NORMAL:
+  case PROMOTION:
+    // a pawn reaching the last rank always promotes
+    if (((end_bb & promotion_rank) != 0) != (move_type == PROMOTION)) {
+      return false;
+    }
+    return (MASKS.pawn_moves_one[player][start] & end_bb & ~occupied) != 0 ||
+           (MASKS.pawn_captures[player][start] & end_bb &
+            side_bbs[opposite(player)]) != 0;
+  case PAWN_TWO_SQUARES_FORWARD:
+    return (MASKS.pawn_moves_two[player][start] & end_bb) != 0 &&
+           ((MASKS.between[start][end] | end_bb) & occupied) == 0;
+  case EN_PASSANT:
+    return end == history[ply].en_passant_square &&
+           (MASKS.pawn_captures[player][start] & end_bb) != 0;
+  default:
+    return false;
+  }
+}
 
-      start_pos = bits::popLSB(piece_bb);
+bool Board::is_legal(const Move &move) const {
+  const Color player = get_player_to_move();
+  const int start = move.get_start();
+  const int end = move.get_end();
+  const int king_pos = bits::lsb(piece_bbs[player][KING]);
+
+  // castling moves are only generated when they are legal
+  if (move.get_move_type() == CASTLING) {
+    return true;
+  }
+  if (move.get_move_type() == EN_PASSANT) {
+    return is_legal_en_passant(start, end);
+  }
+  if (start == king_pos) {
+    const uint64_t occupied = get_occupied() ^ MASKS.squares[start];
+    return get_attackers(end, opposite(player), occupied) == 0;
+  }
+
+  // the same rules as when generating the legal moves
+  const uint64_t checkers = get_checkers();
+  if (checkers != 0) {
+    if (bits::clear_lsb(checkers) != 0) {
+      return false;
+    }
+    const uint64_t target =
+        checkers | MASKS.between[king_pos][bits::lsb(checkers)];
+    if ((target & MASKS.squares[end]) == 0) {
+      return false;
     }
   }
+  return bits::get(get_pinned(), start) == 0 ||
+         (MASKS.lines[king_pos][start] & MASKS.squares[end]) != 0;
+}
+
+bool Board::is_legal_en_passant(int start, int end) const {
+  const Color player = get_player_to_move();
+  const int captured_pos = player == WHITE ? end + 8 : end - 8;
+  // both pawns leave their squares at once,
+  // which can uncover an attack along the rank
+  const uint64_t occupied = (get_occupied() ^
+                             MASKS.squares.at(start) ^
+                             MASKS.squares.at(captured_pos)) |
+                            MASKS.squares.at(end);
+  const int king_pos = bits::lsb(piece_bbs.at(player).at(KING));
+  return get_attackers(king_pos, get_opposite_color(player), occupied) == 0;
+}
 
-  return attacking;
+// the squares attacked by all the pieces of a side,
+// found for every piece type at once rather than piece by piece
+uint64_t Board::get_attacking_bb(Color color) const {
+  attack_computations++;
+  const std::array<uint64_t, 6> &bbs = piece_bbs[color];
+  const uint64_t pawn_attacks =
+      color == WHITE ? masks::white_pawn_captures_mask(bbs[PAWN])
+                     : masks::black_pawn_captures_mask(bbs[PAWN]);
+  return pawn_attacks | masks::knight_moves_mask(bbs[KNIGHT]) |
+         masks::king_moves_mask(bbs[KING]) |
+         attacks::sliders(bbs[ROOK] | bbs[QUEEN], bbs[BISHOP] | bbs[QUEEN],
+                          get_occupied());
 }
 
 bool Board::is_attacking(int pos, Color color) const {
-  std::array<uint64_t, 6> pieces_bb = piece_bbs.at(color);
+  attack_computations++;
+  const std::array<uint64_t, 6> &pieces_bb = piece_bbs.at(color);
 
-  if ((masks.knight_moves.at(pos) & pieces_bb.at(KNIGHT)) != 0) {
+  if ((MASKS.knight_moves.at(pos) & pieces_bb.at(KNIGHT)) != 0) {
     return true;
   }
-  if ((masks.king_moves.at(pos) & pieces_bb.at(KING)) != 0) {
+  if ((MASKS.king_moves.at(pos) & pieces_bb.at(KING)) != 0) {
     return true;
   }
-  if ((masks.pawn_captures.at(get_opposite_color(color)).at(pos) &
+  if ((MASKS.pawn_captures.at(get_opposite_color(color)).at(pos) &
        pieces_bb.at(PAWN)) != 0) {
     return true;
   }
 
-  uint64_t occupied = side_bbs.at(WHITE) | side_bbs.at(BLACK);
+  uint64_t occupied = get_occupied();
   uint64_t bishop_moves = gen_bishop_attacks(pos, occupied);
   if ((bishop_moves & pieces_bb.at(BISHOP)) != 0) {
     return true;
@@ -335,8 +712,9 @@ bool Board::is_attacking(int pos, Color color) const {
 }
 
 bool Board::is_in_check(Color color) const {
-  uint64_t king_bb = piece_bbs.at(color).at(KING);
-  assert(king_bb != 0);
-  int king_pos = bits::popLSB(king_bb).value();
+  if (color == get_player_to_move()) {
+    return get_checkers() != 0;
+  }
+  const int king_pos = bits::lsb(piece_bbs.at(color).at(KING));
   return is_attacking(king_pos, get_opposite_color(color));
 }
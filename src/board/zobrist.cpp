@@ -0,0 +1,61 @@
+#include "zobrist.hpp"
+
+namespace zobrist {
+
+// https://www.chessprogramming.org/Xorshift
+// a fixed seed makes the keys, and therefore the hashes, reproducible
+static uint64_t next_random(uint64_t &state) {
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  return state * 2685821657736338717ULL;
+}
+
+static Keys create_keys() {
+  uint64_t state = 1070372;
+  Keys keys;
+  for (int color = 0; color < 2; color++) {
+    for (int piece = 0; piece < 6; piece++) {
+      for (int pos = 0; pos < 64; pos++) {
+        keys.pieces.at(color).at(piece).at(pos) = next_random(state);
+      }
+    }
+  }
+  for (int color = 0; color < 2; color++) {
+    keys.castling.at(color).at(0) = next_random(state);
+    keys.castling.at(color).at(1) = next_random(state);
+  }
+  for (int rights = 0; rights < 16; rights++) {
+    uint64_t hash = 0;
+    for (int color = 0; color < 2; color++) {
+      if (rights & castling_right((Color)color, true)) {
+        hash ^= keys.castling.at(color).at(0);
+      }
+      if (rights & castling_right((Color)color, false)) {
+        hash ^= keys.castling.at(color).at(1);
+      }
+    }
+    keys.castling_rights.at(rights) = hash;
+  }
+  for (int file = 0; file < 8; file++) {
+    keys.en_passant_file.at(file) = next_random(state);
+  }
+  keys.black_to_move = next_random(state);
+  return keys;
+}
+
+const Keys keys = create_keys();
+
+uint64_t piece(PieceType piece_type, Color color, int pos) {
+  return keys.pieces[color][piece_type][pos];
+}
+
+uint64_t castling(uint8_t castling_rights) {
+  return keys.castling_rights[castling_rights];
+}
+
+uint64_t en_passant(int en_passant_square) {
+  return keys.en_passant_file[en_passant_square % 8];
+}
+
+} // namespace zobrist
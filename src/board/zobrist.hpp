@@ -0,0 +1,23 @@
+#pragma once
+
+#include <array>
+#include <stdint.h>
+
+#include "defs.hpp"
+
+namespace zobrist {
+struct Keys {
+  std::array<std::array<std::array<uint64_t, 64>, 6>, 2> pieces;
+  std::array<std::array<uint64_t, 2>, 2> castling;
+  // the combined keys of every set of castling rights
+  std::array<uint64_t, 16> castling_rights;
+  std::array<uint64_t, 8> en_passant_file;
+  uint64_t black_to_move;
+};
+
+extern const Keys keys;
+
+uint64_t piece(PieceType piece_type, Color color, int pos);
+uint64_t castling(uint8_t castling_rights);
+uint64_t en_passant(int en_passant_square);
+} // namespace zobrist
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <stdint.h>
 #include <string>
 
 enum PieceType { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING };
@@ -15,7 +16,14 @@ struct Castling {
   bool queenside;
 };
 
-enum MoveCategory { ALL, TACTICAL };
+// the castling rights of both players packed into the four lowest bits,
+// the kingside and queenside rights of white followed by those of black
+constexpr uint8_t castling_right(Color color, bool kingside) {
+  return 1 << (2 * color + (kingside ? 0 : 1));
+}
+
+// tactical moves are captures and promotions, quiet moves are all others
+enum MoveCategory { ALL, TACTICAL, QUIET };
 
 const std::string STARTING_POSITION_FEN =
     "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
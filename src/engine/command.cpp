@@ -85,3 +85,18 @@ Command Command::update_board(const std::string &fen,
   };
   return Command(CommandType::UpdateBoard, position);
 }
+
+Command Command::new_game() { return Command(CommandType::NewGame); }
+
+Command Command::set_hash(int size_mb) {
+  return Command(CommandType::SetHash, size_mb);
+}
+
+Command Command::set_threads(int nr_threads) {
+  return Command(CommandType::SetThreads, nr_threads);
+}
+
+bool Command::is_search() const {
+  return type == GoInfinite || type == GoDepth || type == GoMoveTime ||
+         type == GoGameTime;
+}
@@ -14,6 +14,9 @@ enum CommandType {
   GoGameTime,
   GoPerft,
   UpdateBoard,
+  NewGame,
+  SetHash,
+  SetThreads,
 };
 
 struct GameTime {
@@ -56,6 +59,12 @@ public:
   static Command go_perft(int depth);
   static Command update_board(const std::string &fen,
                               const std::vector<std::string> moves);
+  static Command new_game();
+  static Command set_hash(int size_mb);
+  static Command set_threads(int nr_threads);
+
+  // whether the command starts a search that a stop command can end
+  bool is_search() const;
 
 private:
   Command(CommandType type);
@@ -1,9 +1,10 @@
 #include "engine.hpp"
 #include "board/board.hpp"
 #include "engine/command.hpp"
-#include "engine/search.hpp"
 #include "engine/search_defs.hpp"
+#include "engine/thread_pool.hpp"
 #include "engine/time_management.hpp"
+#include "engine/transposition_table.hpp"
 #include "fen.hpp"
 #include "fmt/core.h"
 #include "perft.hpp"
@@ -14,17 +15,15 @@
 
 namespace engine {
 bool make_move(const char *move_uci, Board &board) {
-  const Color player = board.get_player_to_move();
-  const std::vector<Move> pseudo_legal_moves =
-      board.get_pseudo_legal_moves(ALL);
-  for (const Move &move : pseudo_legal_moves) {
+  if (board.get_ply() >= MAX_GAME_PLY) {
+    throw std::invalid_argument(fmt::format(
+        "Illegal move: {} is past the maximum game length of {} plies\n",
+        move_uci, MAX_GAME_PLY));
+  }
+  const MoveList legal_moves = board.get_legal_moves(ALL);
+  for (const Move &move : legal_moves) {
     if (move.to_uci_notation() == std::string(move_uci)) {
       board.make(move);
-      if (board.is_in_check(player)) {
-        board.undo();
-        throw std::invalid_argument(fmt::format(
-            "Illegal move: {} puts the player in check\n", move_uci));
-      }
       return true;
     }
   }
@@ -32,11 +31,16 @@ bool make_move(const char *move_uci, Board &board) {
       fmt::format("Illegal move: {} is not a legal move\n", move_uci));
 }
 
-void execute_command(const Command &command, std::atomic<bool> &stop,
-                     Board &board) {
+void execute_command(const Command &command, Board &board,
+                     TranspositionTable &tt, ThreadPool &thread_pool) {
   switch (command.type) {
   case UCI: {
-    fmt::println("id name {} {}\nid author {}\nuciok\n", NAME, VERSION, AUTHOR);
+    fmt::println("id name {} {}\nid author {}", NAME, VERSION, AUTHOR);
+    fmt::println("option name Hash type spin default {} min 1 max {}",
+                 DEFAULT_HASH_SIZE_MB, MAX_HASH_SIZE_MB);
+    fmt::println("option name Threads type spin default {} min 1 max {}",
+                 DEFAULT_THREADS, MAX_THREADS);
+    fmt::println("uciok\n");
     break;
   }
   case IsReady: {
@@ -69,6 +73,18 @@ void execute_command(const Command &command, std::atomic<bool> &stop,
     free(position.moves);
     break;
   }
+  case NewGame: {
+    tt.clear();
+    break;
+  }
+  case SetHash: {
+    tt.resize(command.arg.integer);
+    break;
+  }
+  case SetThreads: {
+    thread_pool.resize(command.arg.integer);
+    break;
+  }
   case GoPerft: {
     divide(board, command.arg.integer);
     break;
@@ -76,16 +92,14 @@ void execute_command(const Command &command, std::atomic<bool> &stop,
   case GoInfinite: {
     SearchParams params = SearchParams();
     params.search_mode = SearchMode::INFINITE;
-    Search search = Search(board, params, stop);
-    search.iterative_deepening_search();
+    thread_pool.search(board, params);
     break;
   }
   case GoDepth: {
     SearchParams params = SearchParams();
     params.search_mode = SearchMode::DEPTH;
     params.depth = command.arg.integer;
-    Search search = Search(board, params, stop);
-    search.iterative_deepening_search();
+    thread_pool.search(board, params);
     break;
   }
   case GoGameTime: {
@@ -94,8 +108,7 @@ void execute_command(const Command &command, std::atomic<bool> &stop,
     params.allocated_time = calc_allocated_time(board.get_player_to_move(),
                                                 command.arg.game_time.wtime,
                                                 command.arg.game_time.btime);
-    Search search = Search(board, params, stop);
-    search.iterative_deepening_search();
+    thread_pool.search(board, params);
     break;
   }
   case GoMoveTime: {
@@ -104,8 +117,7 @@ void execute_command(const Command &command, std::atomic<bool> &stop,
     // to ensure a move is returned before the allocated time runs out
     int move_overhead = 50;
     params.allocated_time = command.arg.integer - move_overhead;
-    Search search = Search(board, params, stop);
-    search.iterative_deepening_search();
+    thread_pool.search(board, params);
     break;
   }
   }
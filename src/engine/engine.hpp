@@ -4,8 +4,10 @@
 
 #include "board/board.hpp"
 #include "engine/command.hpp"
+#include "engine/thread_pool.hpp"
+#include "engine/transposition_table.hpp"
 
 namespace engine {
-void execute_command(const Command &command, std::atomic<bool> &stop,
-                     Board &board);
+void execute_command(const Command &command, Board &board,
+                     TranspositionTable &tt, ThreadPool &thread_pool);
 };
@@ -0,0 +1,23 @@
+#include "history.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+History::History() { clear(); }
+
+void History::clear() {
+  for (auto &from : table) {
+    for (auto &to : from) {
+      to.fill(0);
+    }
+  }
+}
+
+void History::update(Color player, const Move &move, int bonus) {
+  int &score = table[player][move.get_start()][move.get_end()];
+  bonus = std::clamp(bonus, -MAX_HISTORY, MAX_HISTORY);
+  score += bonus - score * std::abs(bonus) / MAX_HISTORY;
+}
+
+// deeper cutoffs save more work, so they count for more
+int History::bonus(int depth) { return std::min(depth * depth, MAX_HISTORY); }
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+
+#include "defs.hpp"
+#include "move.hpp"
+
+// the scores in the history table stay within plus and minus this value
+const int MAX_HISTORY = 16384;
+
+// How well each quiet move has done elsewhere in the search, by the player
+// making it and its start and end squares. Quiet moves that caused cutoffs
+// are searched first in the positions where no hash or killer move did
+class History {
+public:
+  History();
+
+  int get(Color player, const Move &move) const {
+    return table[player][move.get_start()][move.get_end()];
+  }
+
+  void clear();
+  // Adds the bonus to the score of the move, or subtracts it if negative.
+  // The closer the score already is to the limit, the less it changes,
+  // so moves that stop causing cutoffs lose their score again over time
+  void update(Color player, const Move &move, int bonus);
+
+  // the bonus for a cutoff at the given depth
+  static int bonus(int depth);
+
+private:
+  std::array<std::array<std::array<int, 64>, 64>, 2> table;
+};
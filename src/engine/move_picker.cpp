@@ -0,0 +1,185 @@
+#include "move_picker.hpp"
+
+#include <algorithm>
+
+MovePicker::MovePicker(const Board &board, std::optional<Move> hash_move,
+                       const Killers &killer_moves, const History &history)
+    : board(board), hash_move(hash_move), killer_moves(killer_moves),
+      history(&history), only_tactical(false), stage(HASH_MOVE),
+      hash_move_picked(false), picked_stage(HASH_MOVE), captures_picked(0),
+      captures_generated(false), killers_picked(0), picked_killers{},
+      quiets_picked(0), quiets_generated(false) {}
+
+MovePicker::MovePicker(const Board &board, std::optional<Move> hash_move)
+    : board(board), hash_move(hash_move), killer_moves{}, history(nullptr),
+      only_tactical(true), stage(HASH_MOVE), hash_move_picked(false),
+      picked_stage(HASH_MOVE), captures_picked(0), captures_generated(false),
+      killers_picked(0), picked_killers{}, quiets_picked(0),
+      quiets_generated(false) {}
+
+std::optional<Move> MovePicker::next() {
+  while (true) {
+    switch (stage) {
+    case HASH_MOVE:
+      stage = CAPTURES;
+      if (hash_move.has_value() && is_hash_move_legal() &&
+          !(only_tactical && board.see(hash_move.value()) < 0)) {
+        picked_stage = HASH_MOVE;
+        hash_move_picked = true;
+        return hash_move;
+      }
+      break;
+
+    case CAPTURES: {
+      gen_captures();
+      const std::optional<Move> capture = pick_best_capture();
+      if (capture.has_value()) {
+        picked_stage = CAPTURES;
+        return capture;
+      }
+      stage = only_tactical ? DONE : KILLERS;
+      break;
+    }
+
+    case KILLERS:
+      // the killer moves come from other positions at the same ply
+      while (killers_picked < NR_KILLERS) {
+        const std::optional<Move> killer_move = killer_moves[killers_picked++];
+        if (killer_move.has_value() &&
+            !is_picked_hash_move(killer_move.value()) &&
+            !is_tactical(killer_move.value()) &&
+            board.is_pseudo_legal(killer_move.value()) &&
+            board.is_legal(killer_move.value())) {
+          picked_stage = KILLERS;
+          picked_killers[killers_picked - 1] = killer_move;
+          return killer_move;
+        }
+      }
+      stage = QUIETS;
+      break;
+
+    case QUIETS: {
+      gen_quiets();
+      const std::optional<Move> quiet = pick_best_quiet();
+      if (quiet.has_value()) {
+        picked_stage = QUIETS;
+        return quiet;
+      }
+      stage = DONE;
+      break;
+    }
+
+    case DONE:
+      return std::nullopt;
+    }
+  }
+}
+
+PickerStage MovePicker::get_stage() const { return picked_stage; }
+
+bool MovePicker::is_tactical(const Move &move) const {
+  return move.get_move_type() == PROMOTION ||
+         move.get_move_type() == EN_PASSANT ||
+         board.get_piece_type(move.get_end()).has_value();
+}
+
+// Moves compare equal when they have the same squares and promotion piece,
+// but a stale hash move may have another move type than the legal move
+// with the same squares, so the full encoding is compared
+bool MovePicker::is_picked_hash_move(const Move &move) const {
+  return hash_move_picked && move.get_data() == hash_move.value().get_data();
+}
+
+// the hash move can come from another position with the same hash,
+// so it is checked against the position before it's played
+bool MovePicker::is_hash_move_legal() const {
+  const Move move = hash_move.value();
+  if (only_tactical && !is_tactical(move)) {
+    return false;
+  }
+  return board.is_pseudo_legal(move) && board.is_legal(move);
+}
+
+void MovePicker::gen_captures() {
+  if (captures_generated) {
+    return;
+  }
+  board.get_legal_moves(TACTICAL, captures);
+  for (size_t i = 0; i < captures.size(); i++) {
+    capture_scores[i] = get_capture_score(captures[i]);
+  }
+  captures_generated = true;
+}
+
+void MovePicker::gen_quiets() {
+  if (quiets_generated) {
+    return;
+  }
+  board.get_legal_moves(QUIET, quiets);
+  const Color player = board.get_player_to_move();
+  for (size_t i = 0; i < quiets.size(); i++) {
+    quiet_scores[i] = history->get(player, quiets[i]);
+  }
+  quiets_generated = true;
+}
+
+// only the next best capture is moved to the front,
+// since a cutoff often happens before all the captures have been searched
+std::optional<Move> MovePicker::pick_best_capture() {
+  while (captures_picked < captures.size()) {
+    size_t best = captures_picked;
+    for (size_t i = captures_picked + 1; i < captures.size(); i++) {
+      if (capture_scores[i] > capture_scores[best]) {
+        best = i;
+      }
+    }
+    // the remaining captures all lose material
+    if (only_tactical && capture_scores[best] < 0) {
+      return std::nullopt;
+    }
+    std::swap(captures[captures_picked], captures[best]);
+    std::swap(capture_scores[captures_picked], capture_scores[best]);
+
+    const Move move = captures[captures_picked++];
+    if (!is_picked_hash_move(move)) {
+      return move;
+    }
+  }
+  return std::nullopt;
+}
+
+// the quiet moves are picked in the same way as the captures,
+// ordered by their history scores
+std::optional<Move> MovePicker::pick_best_quiet() {
+  while (quiets_picked < quiets.size()) {
+    size_t best = quiets_picked;
+    for (size_t i = quiets_picked + 1; i < quiets.size(); i++) {
+      if (quiet_scores[i] > quiet_scores[best]) {
+        best = i;
+      }
+    }
+    std::swap(quiets[quiets_picked], quiets[best]);
+    std::swap(quiet_scores[quiets_picked], quiet_scores[best]);
+
+    const Move move = quiets[quiets_picked++];
+    if (!is_picked_hash_move(move) && !is_picked_killer_move(move)) {
+      return move;
+    }
+  }
+  return std::nullopt;
+}
+
+// like the hash move, a killer move may have another move type
+// than the legal move with the same squares
+bool MovePicker::is_picked_killer_move(const Move &move) const {
+  return std::any_of(picked_killers.begin(), picked_killers.end(),
+                     [&](const std::optional<Move> &killer) {
+                       return killer.has_value() &&
+                              killer.value().get_data() == move.get_data();
+                     });
+}
+
+// the material won once all the captures on the end square have been made
+int MovePicker::get_capture_score(const Move &move) const {
+  return board.see(move);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <optional>
+
+#include "board/board.hpp"
+#include "engine/history.hpp"
+#include "move.hpp"
+#include "move_list.hpp"
+
+// the stages a move picker goes through, in the order they are tried
+enum PickerStage { HASH_MOVE, CAPTURES, KILLERS, QUIETS, DONE };
+const int NR_PICKER_STAGES = DONE;
+
+// the quiet moves that last caused cutoffs at a ply, most recent first
+const int NR_KILLERS = 2;
+using Killers = std::array<std::optional<Move>, NR_KILLERS>;
+
+// Hands out the legal moves of a position one at a time, best first.
+// The moves are generated in stages, and a stage is only generated
+// once the moves from the earlier stages failed to cause a cutoff
+class MovePicker {
+public:
+  // picks all legal moves
+  MovePicker(const Board &board, std::optional<Move> hash_move,
+             const Killers &killer_moves, const History &history);
+  // only picks the captures and promotions that don't lose material
+  MovePicker(const Board &board, std::optional<Move> hash_move);
+
+  std::optional<Move> next();
+
+  // the stage of the last move that was picked
+  PickerStage get_stage() const;
+
+  bool is_tactical(const Move &move) const;
+
+private:
+  const Board &board;
+  const std::optional<Move> hash_move;
+  const Killers killer_moves;
+  // only used to order the quiet moves, so it is null when only picking
+  // tactical moves
+  const History *history;
+  const bool only_tactical;
+
+  PickerStage stage;
+  // whether the hash move was legal here and has been picked,
+  // so that the later stages don't pick it again
+  bool hash_move_picked;
+  PickerStage picked_stage;
+
+  MoveList captures;
+  std::array<int, MAX_MOVES> capture_scores;
+  size_t captures_picked;
+  bool captures_generated;
+
+  size_t killers_picked;
+  // the killer moves that were legal here and have been picked
+  std::array<std::optional<Move>, NR_KILLERS> picked_killers;
+
+  MoveList quiets;
+  std::array<int, MAX_MOVES> quiet_scores;
+  size_t quiets_picked;
+  bool quiets_generated;
+
+  bool is_hash_move_legal() const;
+  bool is_picked_hash_move(const Move &move) const;
+  void gen_captures();
+  void gen_quiets();
+  std::optional<Move> pick_best_capture();
+  std::optional<Move> pick_best_quiet();
+  bool is_picked_killer_move(const Move &move) const;
+  int get_capture_score(const Move &move) const;
+};
@@ -1,7 +1,9 @@
 #include "search.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
 #include <fmt/core.h>
 #include <iostream>
 #include <optional>
@@ -11,27 +13,77 @@
 
 #include "board/board.hpp"
 #include "defs.hpp"
+#include "engine/move_picker.hpp"
 #include "engine/search_defs.hpp"
 #include "evaluation/evaluation.hpp"
 #include "move.hpp"
 #include "uci.hpp"
 
-Search::Search(Board &board, SearchParams &params, std::atomic<bool> &stop)
-    : board(board), params(params), stop(stop) {}
+// the reductions of late moves by depth and move number,
+// which grow with the logarithm of both
+using ReductionTable = std::array<std::array<int, 64>, MAX_PLY>;
+
+static ReductionTable create_reductions() {
+  ReductionTable reductions;
+  for (int depth = 0; depth < MAX_PLY; depth++) {
+    for (int move_number = 0; move_number < 64; move_number++) {
+      reductions.at(depth).at(move_number) =
+          depth == 0 || move_number == 0
+              ? 0
+              : (int)(0.75 + std::log(depth) * std::log(move_number) / 2.25);
+    }
+  }
+  return reductions;
+}
 
-void Search::iterative_deepening_search() {
-  // initialize alpha/beta to the value of immediate checkmate
-  // so any legal move will be considered better
-  const int alpha = -CHECKMATE;
-  const int beta = -alpha;
+static const ReductionTable REDUCTIONS = create_reductions();
+
+// the number of moves searched at a shallow depth
+// before the remaining quiet moves are pruned
+static int late_move_count(int depth) { return 3 + depth * depth; }
+
+Search::Search(Board &board, SearchParams &params, std::atomic<bool> &stop,
+               TranspositionTable &tt, std::vector<NodeCounter> &node_counters,
+               int thread_id)
+    : board(board), params(params), stop(stop), tt(tt),
+      node_counters(node_counters), thread_id(thread_id),
+      null_move_verification_ply(-1) {}
+
+// checkmate scores are relative to the root,
+// but they are stored in the transposition table relative to the position
+// so that they stay correct when the position is reached at another ply
+static int score_to_tt(int score, int ply_from_root) {
+  if (score > CHECKMATE_THRESHOLD) {
+    return score + ply_from_root;
+  }
+  if (score < -CHECKMATE_THRESHOLD) {
+    return score - ply_from_root;
+  }
+  return score;
+}
+
+static int score_from_tt(int score, int ply_from_root) {
+  if (score > CHECKMATE_THRESHOLD) {
+    return score - ply_from_root;
+  }
+  if (score < -CHECKMATE_THRESHOLD) {
+    return score + ply_from_root;
+  }
+  return score;
+}
 
+void Search::iterative_deepening_search() {
   // Create a new SearchInfo object
   // it contains all the relevant info about the search
   info = SearchInfo();
-  stop = false;
+  const long attack_computations = board.get_attack_computations();
 
   // will be updated whenever a new best move is found
   std::stack<Move> best_moves;
+  // the nodes searched by the previous iteration
+  long previous_nodes = 0;
+  // the score of the last depth that was completed
+  int score = 0;
 
   // search the position at increasing depths
   // until either the final depth is reached,
@@ -39,38 +91,91 @@ void Search::iterative_deepening_search() {
   while (info.depth < params.depth && !info.is_terminated) {
     info.depth++;
 
-    // will be updated every time a new best line is found
-    std::vector<Move> principal_variation;
+    // let half of the helper threads skip every other depth,
+    // so that the threads don't all search the same tree at the same time
+    if (thread_id % 2 == 1 && info.depth < params.depth) {
+      info.depth++;
+    }
+    info.cutoffs = 0;
+    info.first_move_cutoffs = 0;
+    info.fail_highs = 0;
+    info.fail_lows = 0;
+    const long nodes_before = info.nodes;
 
-    // alpha-beta function
     // evaluate the position at the current depth
-    const int evaluation =
-        alpha_beta(info.depth, alpha, beta, principal_variation);
+    const int evaluation = aspiration_search(score);
 
     // if the search has not been terminated
     // then we can use the result from the search at this depth
-    if (!info.is_terminated) {
+    // only the main thread reports its results
+    if (!info.is_terminated && is_main_thread()) {
       SearchSummary search_summary = {.depth = info.depth,
                                       .seldepth = info.seldepth,
                                       .score = evaluation,
-                                      .nodes = info.nodes,
+                                      .nodes = total_nodes(),
                                       .time = info.time_elapsed(),
-                                      .pv = principal_variation};
+                                      .pv = get_root_pv()};
       assert(search_summary.pv.size() > 0);
       best_moves.push(search_summary.pv.at(0));
 
       fmt::println(uci::show(search_summary));
+      fmt::println(uci::show_cutoffs(info.cutoffs, info.first_move_cutoffs));
+      fmt::println(uci::show_branching_factor(info.nodes - nodes_before,
+                                              previous_nodes));
+      fmt::println(uci::show_aspiration(info.fail_highs, info.fail_lows));
       std::flush(std::cout);
     }
+    previous_nodes = info.nodes - nodes_before;
+    score = evaluation;
   }
   // always finish a search by outputting the best move
-  fmt::println(uci::bestmove(best_moves.top()));
-  std::flush(std::cout);
+  if (is_main_thread()) {
+    fmt::println(uci::show_stages_reached(info.stages_reached));
+    fmt::println(uci::show_attack_computations(
+        board.get_attack_computations() - attack_computations, info.nodes));
+    fmt::println(uci::bestmove(best_moves.top()));
+    std::flush(std::cout);
+  }
 }
 
-int Search::alpha_beta(int depth, int alpha, int beta,
-                       std::vector<Move> &principal_variation) {
+// The score is expected to be close to the score of the previous depth,
+// and searching with a narrow window around it cuts off more of the tree.
+// If the score falls outside the window, the window is widened on that side
+// until the score is inside it, ending with the value of immediate checkmate
+// so that any legal move will be considered better
+int Search::aspiration_search(int previous_score) {
+  int delta = ASPIRATION_WINDOW;
+  int alpha = -CHECKMATE;
+  int beta = CHECKMATE;
+  if (info.depth >= ASPIRATION_MIN_DEPTH) {
+    alpha = std::max(previous_score - delta, -CHECKMATE);
+    beta = std::min(previous_score + delta, CHECKMATE);
+  }
+
+  while (true) {
+    const int score = params.make_mode == COPY_MAKE
+                          ? alpha_beta<COPY_MAKE>(info.depth, alpha, beta)
+                          : alpha_beta<MAKE_UNDO>(info.depth, alpha, beta);
+    if (info.is_terminated) {
+      return score;
+    }
+    if (score <= alpha && alpha > -CHECKMATE) {
+      info.fail_lows++;
+      alpha = std::max(alpha - delta, -CHECKMATE);
+    } else if (score >= beta && beta < CHECKMATE) {
+      info.fail_highs++;
+      beta = std::min(beta + delta, CHECKMATE);
+    } else {
+      return score;
+    }
+    delta *= 2;
+  }
+}
+
+template <MakeMode make_mode>
+int Search::alpha_beta(int depth, int alpha, int beta) {
   const Color player = board.get_player_to_move();
+  clear_pv();
 
   // if the search has been terminated, then return immediately
   if (is_terminate()) {
@@ -90,49 +195,150 @@ int Search::alpha_beta(int depth, int alpha, int beta,
   // see if there are any winning/losing captures in the position
   // that might change the evaluation of the position
   if (depth == 0) {
-    return quiescence(alpha, beta, principal_variation);
+    return quiescence<make_mode>(alpha, beta);
   }
 
-  std::vector<Move> pseudo_legal_moves = board.get_pseudo_legal_moves(ALL);
-  sort_moves(pseudo_legal_moves);
+  // nodes at depth 0 are counted by the quiescence search
+  count_node();
+
+  // a node searched with a full window needs an exact score and a line,
+  // while a node with a null window only has to fail high or low
+  const bool is_pv_node = beta - alpha > 1;
+
+  // if this position has already been searched deep enough,
+  // the stored result can be used without searching it again.
+  // A stored score may come from another path to the position, where it
+  // wasn't a draw by repetition, so it is only trusted outside the PV
+  std::optional<Move> hash_move;
+  const std::optional<int> tt_score = probe_tt(depth, alpha, beta, hash_move);
+  if (tt_score.has_value() && !is_pv_node && info.ply_from_root > 0) {
+    return tt_score.value();
+  }
 
+  // Passing the move is not allowed in check, and in pawn endgames it is
+  // often better than every legal move, so it can't be used there.
+  // Two null moves in a row would only search the same position again,
+  // and a PV node needs an exact score rather than a cutoff.
+  // A null move can't prove a mate, so it isn't tried against mate scores
+  if (depth >= NULL_MOVE_MIN_DEPTH && info.ply_from_root > 0 && !is_pv_node &&
+      !is_in_check && std::abs(beta) < CHECKMATE_THRESHOLD &&
+      info.ply_from_root != null_move_verification_ply &&
+      !board.last_move_was_null() && board.has_non_pawn_material(player) &&
+      evaluate(board) >= beta) {
+    if (null_move_cutoff<make_mode>(depth, beta)) {
+      tt.store(board.get_hash(), depth, score_to_tt(beta, info.ply_from_root),
+               LOWER_BOUND, std::nullopt);
+      return beta;
+    }
+    if (info.is_terminated) {
+      return 0;
+    }
+  }
+
+  // the moves are generated in stages,
+  // so that a cutoff by an early move saves generating the rest
+  MovePicker move_picker(board, hash_move, get_killer_moves(), history);
+  MoveMaker<make_mode> move_maker(board);
+
+  const int original_alpha = alpha;
+  std::optional<Move> best_move;
   int legal_moves_found = 0;
-  for (const Move &move : pseudo_legal_moves) {
+  // the quiet moves that were searched without causing a cutoff
+  MoveList quiets_searched;
+  for (std::optional<Move> next_move = move_picker.next();
+       next_move.has_value(); next_move = move_picker.next()) {
+    const Move move = next_move.value();
+    const bool is_quiet = !move_picker.is_tactical(move);
+    legal_moves_found++;
 
-    board.make(move);
-    // if the move leaves the king in check, it was not legal
-    // so go to the next move
-    if (board.is_in_check(player)) {
-      board.undo();
+    // the quiet moves without a killer or history score to put them first
+    const bool is_late_quiet =
+        is_quiet && !is_in_check && move_picker.get_stage() == QUIETS;
+    // only the late quiet moves are pruned or reduced, so the others don't
+    // need the check test
+    const bool gives_check = is_late_quiet && board.gives_check(move);
+    // at shallow depths the late quiet moves are rarely better than the moves
+    // before them. The PV needs every move searched, and a move that gives
+    // check may be the start of a mate
+    if (is_late_quiet && !gives_check && !is_pv_node &&
+        info.ply_from_root > 0 && depth <= LMP_MAX_DEPTH &&
+        legal_moves_found > late_move_count(depth)) {
       continue;
     }
+
+    move_maker.make(move);
     info.ply_from_root++;
     if (info.ply_from_root > info.seldepth) {
       info.seldepth = info.ply_from_root;
     }
 
-    // if the move didn't leave the king in check, it's a legal move
-    legal_moves_found++;
-
-    std::vector<Move> variation;
-
     // assume the position is a draw
     int evaluation = DRAW;
+    // the draw has no continuation
+    clear_pv();
 
     // if it's not a draw we must search further
     if (!board.is_draw()) {
-      // call search function again and decrease the depth
-      evaluation = -alpha_beta(depth - 1, -beta, -alpha, variation);
+      // late quiet moves are searched to a reduced depth first,
+      // since they are unlikely to raise alpha.
+      // The moves of a PV node are reduced less, since its score is exact
+      int reduction = 0;
+      if (is_late_quiet && !gives_check && depth >= LMR_MIN_DEPTH &&
+          legal_moves_found >= LMR_MIN_MOVE_NUMBER) {
+        reduction = get_reduction(depth, legal_moves_found) -
+                    (is_pv_node ? 1 : 0);
+        reduction = std::clamp(reduction, 0, depth - 2);
+      }
+
+      if (legal_moves_found == 1) {
+        // call search function again and decrease the depth
+        evaluation = -alpha_beta<make_mode>(depth - 1, -beta, -alpha);
+      } else {
+        // the first move is expected to be the best,
+        // so the later moves only have to be proven worse than it,
+        // which a search with a null window does faster
+        evaluation =
+            -alpha_beta<make_mode>(depth - 1 - reduction, -alpha - 1, -alpha);
+
+        // the reduced search can't be trusted when it raises alpha,
+        // so the move is searched again to the full depth
+        if (reduction > 0 && evaluation > alpha && !info.is_terminated) {
+          evaluation = -alpha_beta<make_mode>(depth - 1, -alpha - 1, -alpha);
+        }
+        // a move that is better than the first one
+        // needs its exact score from a search with the full window
+        if (evaluation > alpha && evaluation < beta && !info.is_terminated) {
+          evaluation = -alpha_beta<make_mode>(depth - 1, -beta, -alpha);
+        }
+      }
     }
 
-    board.undo();
+    move_maker.undo();
     info.ply_from_root--;
 
+    // the evaluation of a terminated search can't be trusted
+    if (info.is_terminated) {
+      return 0;
+    }
+
     // if the evaluation is higher than beta
     // it means that the this move is guaranteed to be worse than a previous
     // move we could play so we don't have to consider this variation any
     // further
     if (evaluation >= beta) {
+      info.stages_reached.at(move_picker.get_stage())++;
+      info.cutoffs++;
+      if (legal_moves_found == 1) {
+        info.first_move_cutoffs++;
+      }
+      // a quiet move that refutes a position
+      // is often a good move in the neighbouring positions as well
+      if (is_quiet) {
+        set_killer_move(move);
+        update_history(move, quiets_searched, depth);
+      }
+      tt.store(board.get_hash(), depth,
+               score_to_tt(beta, info.ply_from_root), LOWER_BOUND, move);
       return beta;
     }
 
@@ -142,10 +348,13 @@ int Search::alpha_beta(int depth, int alpha, int beta,
 
       // then we can update alpha accordingly
       alpha = evaluation;
+      best_move = move;
 
       // and set the principal variation to the line that gave this evaluation
-      variation.insert(variation.begin(), move);
-      principal_variation = variation;
+      update_pv(move);
+    }
+    if (is_quiet) {
+      quiets_searched.push_back(move);
     }
   }
 
@@ -163,60 +372,144 @@ int Search::alpha_beta(int depth, int alpha, int beta,
     // otherwise it is stalemate
     return DRAW;
   }
+  info.stages_reached.at(move_picker.get_stage())++;
+
+  // if no move raised alpha, the evaluation is only an upper bound
+  const Bound bound = alpha > original_alpha ? EXACT : UPPER_BOUND;
+  tt.store(board.get_hash(), depth, score_to_tt(alpha, info.ply_from_root),
+           bound, best_move);
 
   // return the best evaluation that was found
   return alpha;
 }
 
-int Search::quiescence(int alpha, int beta,
-                       std::vector<Move> &principal_variation) {
+template <MakeMode make_mode> int Search::quiescence(int alpha, int beta) {
+  clear_pv();
   if (is_terminate()) {
     info.is_terminated = true;
     return 0;
   }
 
-  info.nodes++;
+  count_node();
+
+  std::optional<Move> hash_move;
+  const std::optional<int> tt_score = probe_tt(0, alpha, beta, hash_move);
+  if (tt_score.has_value()) {
+    return tt_score.value();
+  }
+
   int evaluation = evaluate(board);
   if (evaluation >= beta) {
     return beta;
   }
+  const int original_alpha = alpha;
   if (evaluation > alpha) {
     alpha = evaluation;
   }
 
-  const Color player = board.get_player_to_move();
-  std::vector<Move> captures = board.get_pseudo_legal_moves(TACTICAL);
-  sort_moves(captures);
-  for (const Move &capture : captures) {
-    board.make(capture);
-    if (board.is_in_check(player)) {
-      board.undo();
-      continue;
-    }
-
+  MovePicker move_picker(board, hash_move);
+  MoveMaker<make_mode> move_maker(board);
+  std::optional<Move> best_move;
+  for (std::optional<Move> next_move = move_picker.next();
+       next_move.has_value(); next_move = move_picker.next()) {
+    const Move capture = next_move.value();
+    move_maker.make(capture);
     info.ply_from_root++;
     if (info.ply_from_root > info.seldepth) {
       info.seldepth = info.ply_from_root;
     }
 
-    std::vector<Move> variation;
-    evaluation = -quiescence(-beta, -alpha, variation);
-    board.undo();
+    evaluation = -quiescence<make_mode>(-beta, -alpha);
+    move_maker.undo();
     info.ply_from_root--;
 
+    if (info.is_terminated) {
+      return 0;
+    }
+
     if (evaluation >= beta) {
+      tt.store(board.get_hash(), 0, score_to_tt(beta, info.ply_from_root),
+               LOWER_BOUND, capture);
       return beta;
     }
     if (evaluation > alpha) {
       alpha = evaluation;
-      variation.insert(variation.begin(), capture);
-      principal_variation = variation;
+      best_move = capture;
+      update_pv(capture);
     }
   }
 
+  const Bound bound = alpha > original_alpha ? EXACT : UPPER_BOUND;
+  tt.store(board.get_hash(), 0, score_to_tt(alpha, info.ply_from_root), bound,
+           best_move);
   return alpha;
 }
 
+// If the position is still good enough for a cutoff when the opponent
+// gets to move twice in a row, a real move would almost certainly be good
+// enough as well, so a reduced search after a null move is enough to prove it
+template <MakeMode make_mode>
+bool Search::null_move_cutoff(int depth, int beta) {
+  // deeper searches can afford to be reduced more
+  const int reduction = depth > 6 ? 3 : 2;
+
+  board.make_null();
+  info.ply_from_root++;
+  int score = -alpha_beta<make_mode>(depth - 1 - reduction, -beta, -beta + 1);
+  board.undo_null();
+  info.ply_from_root--;
+  if (info.is_terminated || score < beta) {
+    return false;
+  }
+
+  // in zugzwang every move is worse than passing, so the null move cutoff
+  // is wrong. Deep cutoffs prune the most, so they are verified by a
+  // reduced search of the real moves. Only this node skips the null move
+  // in the new search, the nodes below it can still use theirs
+  if (depth >= NULL_MOVE_VERIFICATION_DEPTH) {
+    const int previous_verification_ply = null_move_verification_ply;
+    null_move_verification_ply = info.ply_from_root;
+    score = alpha_beta<make_mode>(depth - 1 - reduction, beta - 1, beta);
+    null_move_verification_ply = previous_verification_ply;
+    if (info.is_terminated || score < beta) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::optional<int> Search::probe_tt(int depth, int alpha, int beta,
+                                    std::optional<Move> &hash_move) {
+  const std::optional<TTEntry> entry = tt.probe(board.get_hash());
+  if (!entry.has_value()) {
+    return std::nullopt;
+  }
+
+  // the best move from an earlier search is likely to be good again,
+  // even if the entry isn't deep enough to use its score
+  hash_move = entry.value().get_move();
+  if (entry.value().depth < depth) {
+    return std::nullopt;
+  }
+
+  const int score = score_from_tt(entry.value().score, info.ply_from_root);
+  switch (entry.value().bound) {
+  case EXACT:
+    return std::clamp(score, alpha, beta);
+  case LOWER_BOUND:
+    if (score >= beta) {
+      return beta;
+    }
+    break;
+  case UPPER_BOUND:
+    if (score <= alpha) {
+      return alpha;
+    }
+    break;
+  }
+  return std::nullopt;
+}
+
 bool Search::is_terminate() {
   // don't terminate if search hasn't completed to depth 1 at least
   // because then we haven't found a best move yet
@@ -244,21 +537,82 @@ bool Search::is_terminate() {
   return false;
 }
 
-void Search::sort_moves(std::vector<Move> &moves) {
-  auto sort_mvv_lva = [&](Move i, Move j) {
-    return get_move_score(i) > get_move_score(j);
-  };
-  std::sort(moves.begin(), moves.end(), sort_mvv_lva);
+bool Search::is_main_thread() const { return thread_id == 0; }
+
+// Every node of the main and quiescence searches is counted, also in the
+// counter the other threads read to report the nodes of all threads
+void Search::count_node() {
+  info.nodes++;
+  node_counters[thread_id].nodes.store(info.nodes, std::memory_order_relaxed);
+}
+
+long Search::total_nodes() const {
+  long nodes = 0;
+  for (const NodeCounter &node_counter : node_counters) {
+    nodes += node_counter.nodes.load(std::memory_order_relaxed);
+  }
+  return nodes;
+}
+
+Killers Search::get_killer_moves() const {
+  if (info.ply_from_root >= MAX_PLY) {
+    return {};
+  }
+  return killer_moves.at(info.ply_from_root);
+}
+
+// the older killer move is replaced, unless the move already is a killer move
+void Search::set_killer_move(const Move &move) {
+  if (info.ply_from_root >= MAX_PLY) {
+    return;
+  }
+  Killers &killers = killer_moves.at(info.ply_from_root);
+  if (killers[0] != move) {
+    killers[1] = killers[0];
+    killers[0] = move;
+  }
+}
+
+// the move that caused the cutoff is rewarded,
+// and the quiet moves that were searched before it are penalized
+void Search::update_history(const Move &move, const MoveList &quiets_searched,
+                            int depth) {
+  const Color player = board.get_player_to_move();
+  const int bonus = History::bonus(depth);
+  history.update(player, move, bonus);
+  for (const Move &quiet : quiets_searched) {
+    history.update(player, quiet, -bonus);
+  }
 }
 
-int Search::get_move_score(const Move &move) {
-  const std::optional<PieceType> start_piece = board.get_piece_type(move.start);
-  const std::optional<PieceType> end_piece = board.get_piece_type(move.end);
+int Search::get_reduction(int depth, int move_number) {
+  return REDUCTIONS.at(std::min(depth, MAX_PLY - 1))
+      .at(std::min(move_number, 63));
+}
 
-  // score non-capture moves lower than captures
-  if (!end_piece) {
-    return -QUEEN_VALUE;
+void Search::clear_pv() {
+  if (info.ply_from_root < MAX_PLY) {
+    pv_length[info.ply_from_root] = 0;
   }
-  return get_piece_value(end_piece.value()) -
-         get_piece_value(start_piece.value());
+}
+
+// the move that raised alpha, followed by the principal variation
+// that the search after it left at the next ply
+void Search::update_pv(const Move &move) {
+  const int ply = info.ply_from_root;
+  if (ply >= MAX_PLY) {
+    return;
+  }
+  pv_table[ply][0] = move;
+  pv_length[ply] = 1;
+  if (ply + 1 < MAX_PLY) {
+    std::copy_n(pv_table[ply + 1].begin(), pv_length[ply + 1],
+                pv_table[ply].begin() + 1);
+    pv_length[ply] += pv_length[ply + 1];
+  }
+}
+
+std::vector<Move> Search::get_root_pv() const {
+  return std::vector<Move>(pv_table[0].begin(),
+                           pv_table[0].begin() + pv_length[0]);
 }
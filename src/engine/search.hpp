@@ -1,10 +1,14 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <vector>
 
 #include "board/board.hpp"
+#include "engine/history.hpp"
+#include "engine/move_picker.hpp"
 #include "engine/search_defs.hpp"
+#include "engine/transposition_table.hpp"
 #include "move.hpp"
 
 class Search {
@@ -12,18 +16,48 @@ public:
   const SearchParams params;
   SearchInfo info;
 
-  Search(Board &board, SearchParams &params, std::atomic<bool> &stop);
+  Search(Board &board, SearchParams &params, std::atomic<bool> &stop,
+         TranspositionTable &tt, std::vector<NodeCounter> &node_counters,
+         int thread_id);
 
   void iterative_deepening_search();
 
 private:
   Board &board;
   std::atomic<bool> &stop;
+  TranspositionTable &tt;
+  std::vector<NodeCounter> &node_counters;
+  const int thread_id;
 
-  int alpha_beta(int depth, int alpha, int beta,
-                 std::vector<Move> &principal_variation);
-  int quiescence(int alpha, int beta, std::vector<Move> &principal_variation);
+  // the last quiet moves that caused a cutoff at each ply
+  std::array<Killers, MAX_PLY> killer_moves;
+  History history;
+  // the ply of the node whose null move cutoff is being verified by
+  // searching it again, where no null move is tried, or -1
+  int null_move_verification_ply;
+
+  // A triangular table of principal variations: the one at a ply is the move
+  // that raised alpha there, followed by the principal variation of the next
+  // ply, so a ply never uses more than MAX_PLY - ply of its row
+  std::array<std::array<Move, MAX_PLY>, MAX_PLY> pv_table;
+  std::array<int, MAX_PLY> pv_length;
+
+  int aspiration_search(int previous_score);
+  template <MakeMode make_mode> int alpha_beta(int depth, int alpha, int beta);
+  template <MakeMode make_mode> int quiescence(int alpha, int beta);
+  template <MakeMode make_mode> bool null_move_cutoff(int depth, int beta);
   bool is_terminate();
-  void sort_moves(std::vector<Move> &moves);
-  int get_move_score(const Move &move);
+  bool is_main_thread() const;
+  void count_node();
+  long total_nodes() const;
+  Killers get_killer_moves() const;
+  void set_killer_move(const Move &move);
+  void update_history(const Move &move, const MoveList &quiets_searched,
+                      int depth);
+  static int get_reduction(int depth, int move_number);
+  void clear_pv();
+  void update_pv(const Move &move);
+  std::vector<Move> get_root_pv() const;
+  std::optional<int> probe_tt(int depth, int alpha, int beta,
+                              std::optional<Move> &hash_move);
 };
@@ -4,6 +4,7 @@ SearchParams::SearchParams() {
   depth = MAX_PLY;
   allocated_time = 0;
   search_mode = INFINITE;
+  make_mode = MAKE_UNDO;
 }
 
 SearchInfo::SearchInfo() {
@@ -13,6 +14,11 @@ SearchInfo::SearchInfo() {
   seldepth = 0;
   nodes = 0;
   is_terminated = false;
+  stages_reached.fill(0);
+  cutoffs = 0;
+  first_move_cutoffs = 0;
+  fail_highs = 0;
+  fail_lows = 0;
 }
 
 int SearchInfo::time_elapsed() const {
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <vector>
 
+#include "board/board.hpp"
+#include "engine/move_picker.hpp"
 #include "move.hpp"
 
 enum SearchMode { DEPTH, MOVE_TIME, INFINITE };
@@ -11,6 +15,7 @@ struct SearchParams {
   int depth;
   int allocated_time;
   SearchMode search_mode;
+  MakeMode make_mode;
 
   SearchParams();
 };
@@ -28,11 +33,32 @@ struct SearchInfo {
   long nodes;
   bool is_terminated;
 
+  // the number of nodes where the move picker
+  // got no further than each stage
+  std::array<long, NR_PICKER_STAGES> stages_reached;
+
+  // the number of nodes at the current depth where a move caused a cutoff,
+  // and where it was the first move searched
+  long cutoffs;
+  long first_move_cutoffs;
+
+  // the number of times the score at the current depth fell outside
+  // the aspiration window, above or below it
+  long fail_highs;
+  long fail_lows;
+
   SearchInfo();
 
   int time_elapsed() const;
 };
 
+// the number of nodes searched by one thread, published so that the main
+// thread can report the total. Each counter has its own cache line so the
+// threads don't slow each other down when updating them
+struct alignas(64) NodeCounter {
+  std::atomic<long> nodes;
+};
+
 struct SearchSummary {
   int depth;
   int seldepth;
@@ -46,3 +72,16 @@ const int MAX_PLY = 100;
 const int DRAW = 0;
 const int CHECKMATE = 50000;
 const int CHECKMATE_THRESHOLD = 49000;
+// the shallowest depth at which null moves are tried,
+// and the depth from which a null move cutoff is verified
+const int NULL_MOVE_MIN_DEPTH = 3;
+const int NULL_MOVE_VERIFICATION_DEPTH = 8;
+// late quiet moves are reduced from this depth and move number,
+// and are pruned up to this depth
+const int LMR_MIN_DEPTH = 3;
+const int LMR_MIN_MOVE_NUMBER = 4;
+const int LMP_MAX_DEPTH = 3;
+// the depth from which the root is searched with a window
+// around the previous score, and half the initial width of the window
+const int ASPIRATION_MIN_DEPTH = 4;
+const int ASPIRATION_WINDOW = 50;
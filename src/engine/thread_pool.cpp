@@ -0,0 +1,91 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+#include "engine/search.hpp"
+
+ThreadPool::ThreadPool(std::atomic<bool> &stop, TranspositionTable &tt)
+    : stop(stop), helpers_stop(false), tt(tt), node_counters(DEFAULT_THREADS),
+      search_id(0), helpers_searching(0), exit(false), root_board(nullptr) {
+  resize(DEFAULT_THREADS);
+}
+
+ThreadPool::~ThreadPool() { stop_helpers(); }
+
+void ThreadPool::resize(int nr_threads) {
+  nr_threads = std::clamp(nr_threads, 1, MAX_THREADS);
+  stop_helpers();
+
+  node_counters = std::vector<NodeCounter>(nr_threads);
+  exit = false;
+  // the engine thread itself acts as the main search thread
+  for (int thread_id = 1; thread_id < nr_threads; thread_id++) {
+    helpers.emplace_back(&ThreadPool::run_helper, this, thread_id, search_id);
+  }
+}
+
+void ThreadPool::stop_helpers() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    exit = true;
+  }
+  search_started.notify_all();
+  for (std::thread &helper : helpers) {
+    helper.join();
+  }
+  helpers.clear();
+}
+
+void ThreadPool::search(const Board &board, const SearchParams &params) {
+  tt.new_search();
+  for (NodeCounter &node_counter : node_counters) {
+    node_counter.nodes = 0;
+  }
+
+  // the helpers copy the board before the main thread starts changing its
+  // own copy, so the original is never modified while they read it
+  Board main_board = board;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    root_board = &board;
+    root_params = params;
+    helpers_stop = false;
+    helpers_searching = helpers.size();
+    search_id++;
+  }
+  search_started.notify_all();
+
+  SearchParams main_params = params;
+  Search search(main_board, main_params, stop, tt, node_counters, 0);
+  search.iterative_deepening_search();
+
+  // the main thread decides when the search is over,
+  // so the helpers are stopped as soon as it has found its best move
+  helpers_stop = true;
+  std::unique_lock<std::mutex> lock(mutex);
+  helpers_finished.wait(lock, [&] { return helpers_searching == 0; });
+}
+
+void ThreadPool::run_helper(int thread_id, int last_search_id) {
+  while (true) {
+    std::unique_lock<std::mutex> lock(mutex);
+    search_started.wait(
+        lock, [&] { return exit || search_id != last_search_id; });
+    if (exit) {
+      return;
+    }
+    last_search_id = search_id;
+    Board board = *root_board;
+    SearchParams params = root_params;
+    lock.unlock();
+
+    Search search(board, params, helpers_stop, tt, node_counters, thread_id);
+    search.iterative_deepening_search();
+
+    lock.lock();
+    helpers_searching--;
+    if (helpers_searching == 0) {
+      helpers_finished.notify_all();
+    }
+  }
+}
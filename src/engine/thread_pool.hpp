@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "board/board.hpp"
+#include "engine/search_defs.hpp"
+#include "engine/transposition_table.hpp"
+
+const int DEFAULT_THREADS = 1;
+const int MAX_THREADS = 256;
+
+// Lazy SMP: helper threads search the same position as the main thread,
+// each on its own copy of the board, and share their results only through
+// the transposition table. The helpers are created once and wait for the
+// next search in between searches.
+class ThreadPool {
+public:
+  ThreadPool(std::atomic<bool> &stop, TranspositionTable &tt);
+  ~ThreadPool();
+
+  void resize(int nr_threads);
+  void search(const Board &board, const SearchParams &params);
+
+private:
+  // the stop command from the user ends the main thread's search, which
+  // then ends the helpers' searches. Only the input thread writes the
+  // user's flag, so that it can reset it without racing with the search
+  std::atomic<bool> &stop;
+  std::atomic<bool> helpers_stop;
+  TranspositionTable &tt;
+  std::vector<std::thread> helpers;
+  std::vector<NodeCounter> node_counters;
+
+  std::mutex mutex;
+  std::condition_variable search_started;
+  std::condition_variable helpers_finished;
+  int search_id;
+  int helpers_searching;
+  bool exit;
+  const Board *root_board;
+  SearchParams root_params;
+
+  void run_helper(int thread_id, int last_search_id);
+  void stop_helpers();
+};
@@ -0,0 +1,139 @@
+#include "transposition_table.hpp"
+
+#include <algorithm>
+
+const int GENERATIONS = 64;
+// an entry for the same position from the current search is only replaced
+// by a store at most this much shallower, unless the new score is exact
+const int REPLACE_DEPTH_MARGIN = 2;
+
+std::optional<Move> TTEntry::get_move() const {
+  if (move == 0) {
+    return std::nullopt;
+  }
+  return Move::from_data(move);
+}
+
+// the data of an entry is packed into one word:
+// bits 0-31 score, bits 32-47 move, bits 48-55 depth,
+// bits 56-57 bound and bits 58-63 generation
+static uint64_t pack(int score, uint16_t move, int depth, Bound bound,
+                     uint8_t generation) {
+  return (uint64_t)(uint32_t)score | (uint64_t)move << 32 |
+         (uint64_t)(uint8_t)depth << 48 | (uint64_t)bound << 56 |
+         (uint64_t)generation << 58;
+}
+
+static TTEntry unpack(uint64_t key, uint64_t data) {
+  return {
+      .key = key,
+      .score = (int32_t)(uint32_t)data,
+      .move = (uint16_t)(data >> 32),
+      .depth = (uint8_t)(data >> 48),
+      .bound = (Bound)((data >> 56) & 0x3),
+      .generation = (uint8_t)(data >> 58),
+  };
+}
+
+static std::optional<TTEntry> load(const TTSlot &slot, uint64_t key) {
+  const uint64_t data = slot.data.load(std::memory_order_relaxed);
+  const uint64_t stored_key = slot.key.load(std::memory_order_relaxed) ^ data;
+  if (stored_key != key) {
+    return std::nullopt;
+  }
+  return unpack(key, data);
+}
+
+TranspositionTable::TranspositionTable(int size_mb) : generation(0) {
+  resize(size_mb);
+}
+
+void TranspositionTable::resize(int size_mb) {
+  size_mb = std::clamp(size_mb, 1, MAX_HASH_SIZE_MB);
+
+  // use the largest power of two number of buckets that fits in the given
+  // size, so that the index can be found with a mask instead of a division
+  const size_t max_buckets = (size_t)size_mb * 1024 * 1024 / sizeof(TTBucket);
+  size_t nr_buckets = 1;
+  while (nr_buckets * 2 <= max_buckets) {
+    nr_buckets *= 2;
+  }
+
+  buckets = std::vector<TTBucket>(nr_buckets);
+  clear();
+}
+
+void TranspositionTable::clear() {
+  for (TTBucket &bucket : buckets) {
+    for (TTSlot &slot : bucket.slots) {
+      slot.key.store(0, std::memory_order_relaxed);
+      slot.data.store(0, std::memory_order_relaxed);
+    }
+  }
+  generation = 0;
+}
+
+void TranspositionTable::new_search() {
+  generation = (generation + 1) % GENERATIONS;
+}
+
+TTBucket &TranspositionTable::get_bucket(uint64_t key) {
+  return buckets[key & (buckets.size() - 1)];
+}
+
+const TTBucket &TranspositionTable::get_bucket(uint64_t key) const {
+  return buckets[key & (buckets.size() - 1)];
+}
+
+std::optional<TTEntry> TranspositionTable::probe(uint64_t key) const {
+  for (const TTSlot &slot : get_bucket(key).slots) {
+    std::optional<TTEntry> entry = load(slot, key);
+    if (entry.has_value()) {
+      return entry;
+    }
+  }
+  return std::nullopt;
+}
+
+void TranspositionTable::store(uint64_t key, int depth, int score, Bound bound,
+                               std::optional<Move> best_move) {
+  TTBucket &bucket = get_bucket(key);
+
+  // overwrite the entry for the same position if there is one,
+  // otherwise replace the shallowest entry, preferring old searches
+  TTSlot *replace = &bucket.slots[0];
+  std::optional<TTEntry> previous;
+  int replace_worth = INT32_MAX;
+  for (TTSlot &slot : bucket.slots) {
+    previous = load(slot, key);
+    if (previous.has_value()) {
+      replace = &slot;
+      break;
+    }
+    const uint64_t data = slot.data.load(std::memory_order_relaxed);
+    const TTEntry entry = unpack(0, data);
+    const int age = (GENERATIONS + generation - entry.generation) % GENERATIONS;
+    const int worth = entry.depth - 8 * age;
+    if (worth < replace_worth) {
+      replace = &slot;
+      replace_worth = worth;
+    }
+  }
+
+  // a shallow search, such as quiescence, mustn't replace the bound and
+  // best move of a deeper search of the same position
+  if (previous.has_value() && previous.value().generation == generation &&
+      bound != EXACT &&
+      depth < previous.value().depth - REPLACE_DEPTH_MARGIN) {
+    return;
+  }
+
+  // keep the previous best move if this search didn't find one
+  const uint16_t move = best_move.has_value() ? best_move.value().get_data()
+                        : previous.has_value() ? previous.value().move
+                                               : 0;
+
+  const uint64_t data = pack(score, move, depth, bound, generation);
+  replace->key.store(key ^ data, std::memory_order_relaxed);
+  replace->data.store(data, std::memory_order_relaxed);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <optional>
+#include <stdint.h>
+#include <vector>
+
+#include "move.hpp"
+
+enum Bound { EXACT, LOWER_BOUND, UPPER_BOUND };
+
+struct TTEntry {
+  uint64_t key;
+  int score;
+  uint16_t move;
+  uint8_t depth;
+  Bound bound;
+  uint8_t generation;
+
+  std::optional<Move> get_move() const;
+};
+
+// the table is shared by all search threads without any locking.
+// an entry is stored as two words, the packed data and the key xor:ed with
+// the data, so an entry torn by two threads writing at the same time
+// no longer matches its key and is treated as empty
+struct TTSlot {
+  std::atomic<uint64_t> key;
+  std::atomic<uint64_t> data;
+};
+
+// four entries fill exactly one cache line,
+// so a probe only ever touches a single line of memory
+struct alignas(64) TTBucket {
+  std::array<TTSlot, 4> slots;
+};
+
+const int DEFAULT_HASH_SIZE_MB = 16;
+const int MAX_HASH_SIZE_MB = 65536;
+
+class TranspositionTable {
+public:
+  TranspositionTable(int size_mb);
+
+  void resize(int size_mb);
+  void clear();
+  void new_search();
+
+  std::optional<TTEntry> probe(uint64_t key) const;
+  void store(uint64_t key, int depth, int score, Bound bound,
+             std::optional<Move> best_move);
+
+private:
+  std::vector<TTBucket> buckets;
+  uint8_t generation;
+
+  TTBucket &get_bucket(uint64_t key);
+  const TTBucket &get_bucket(uint64_t key) const;
+};
@@ -12,6 +12,8 @@
 
 #include "engine/command.hpp"
 #include "engine/engine.hpp"
+#include "engine/thread_pool.hpp"
+#include "engine/transposition_table.hpp"
 #include "uci.hpp"
 
 #ifdef _WIN32
@@ -23,6 +25,11 @@ void read_input(HANDLE wd, std::atomic<bool> &stop) {
       stop = true;
     } else {
       Command command = uci::process(input);
+      // the flag is reset before the search is queued,
+      // so that a stop sent right after the go command isn't lost
+      if (command.is_search()) {
+        stop = false;
+      }
       WriteFile(wd, &command, sizeof(command), NULL, NULL);
     }
   }
@@ -36,6 +43,11 @@ void read_input(int wd, std::atomic<bool> &stop) {
       stop = true;
     } else {
       Command command = uci::process(input);
+      // the flag is reset before the search is queued,
+      // so that a stop sent right after the go command isn't lost
+      if (command.is_search()) {
+        stop = false;
+      }
       write(wd, &command, sizeof(command));
     }
   }
@@ -45,19 +57,23 @@ void read_input(int wd, std::atomic<bool> &stop) {
 #ifdef _WIN32
 void run_engine(HANDLE rd, std::atomic<bool> &stop) {
   Board board = Board::get_starting_position();
+  TranspositionTable tt(DEFAULT_HASH_SIZE_MB);
+  ThreadPool thread_pool(stop, tt);
   Command command;
   while (true) {
     ReadFile(rd, &command, sizeof(command), NULL, NULL);
-    engine::execute_command(command, stop, board);
+    engine::execute_command(command, board, tt, thread_pool);
   }
 }
 #else
 void run_engine(int rd, std::atomic<bool> &stop) {
   Board board = Board::get_starting_position();
+  TranspositionTable tt(DEFAULT_HASH_SIZE_MB);
+  ThreadPool thread_pool(stop, tt);
   Command command;
   while (true) {
     read(rd, &command, sizeof(command));
-    engine::execute_command(command, stop, board);
+    engine::execute_command(command, board, tt, thread_pool);
   }
 }
 #endif
@@ -3,37 +3,33 @@
 #include "fmt/core.h"
 #include "utils.hpp"
 
-Move::Move(int start, int end) : start(start), end(end), move_type(NORMAL) {}
+Move::Move(int start, int end) : Move(start, end, NORMAL) {}
 
 Move::Move(int start, int end, MoveType move_type)
-    : start(start), end(end), move_type(move_type) {}
+    : data(start | end << 6 | move_type << 12) {}
 
 Move::Move(int start, int end, PieceType promotion_piece)
-    : start(start), end(end), move_type(PROMOTION),
-      promotion_piece(promotion_piece) {}
+    : data(start | end << 6 |
+           (PROMOTION_FLAG | (promotion_piece - KNIGHT)) << 12) {}
 
-Move::Move(const Move &move)
-    : start(move.start), end(move.end), move_type(move.move_type),
-      promotion_piece(move.promotion_piece) {}
-
-Move &Move::operator=(const Move &move) {
-  this->start = move.start;
-  this->end = move.end;
-  this->move_type = move.move_type;
-  this->promotion_piece = move.promotion_piece;
-  return *this;
+Move Move::from_data(uint16_t data) {
+  Move move;
+  move.data = data;
+  return move;
 }
 
 bool Move::operator==(const Move &move) const {
-  return move.start == start && move.end == end;
+  return move.get_start() == get_start() && move.get_end() == get_end() &&
+         move.get_promotion_piece() == get_promotion_piece();
 }
 
 std::string Move::to_uci_notation() const {
+  std::optional<PieceType> promotion_piece = get_promotion_piece();
   std::string promotion_piece_str =
       promotion_piece
           ? std::string(1, tolower(get_char_representation(*promotion_piece)))
           : "";
 
-  return fmt::format("{}{}{}", SQUARES.at(start), SQUARES.at(end),
+  return fmt::format("{}{}{}", SQUARES.at(get_start()), SQUARES.at(get_end()),
                      promotion_piece_str);
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <optional>
+#include <stdint.h>
 #include <string>
+#include <type_traits>
 
 #include "defs.hpp"
 
@@ -13,20 +15,47 @@ enum MoveType {
   PAWN_TWO_SQUARES_FORWARD
 };
 
+// A move packed into 16 bits:
+// bits 0-5 start square, bits 6-11 end square and bits 12-15 a flag.
+// The flag is the move type, except for promotions where the highest bit is
+// set and the two lowest bits hold the promotion piece.
 class Move {
 public:
-  int start;
-  int end;
-  MoveType move_type;
-  std::optional<PieceType> promotion_piece;
-
+  // left uninitialized so that move lists can be allocated cheaply
+  Move() = default;
   Move(int start, int end);
   Move(int start, int end, MoveType move_type);
   Move(int start, int end, PieceType promotion_piece);
-  Move(const Move &move);
 
-  Move &operator=(const Move &move);
+  static Move from_data(uint16_t data);
+
+  int get_start() const { return data & 0x3F; }
+  int get_end() const { return (data >> 6) & 0x3F; }
+  MoveType get_move_type() const {
+    return is_promotion() ? PROMOTION : (MoveType)get_flag();
+  }
+  std::optional<PieceType> get_promotion_piece() const {
+    if (!is_promotion()) {
+      return std::nullopt;
+    }
+    return (PieceType)(KNIGHT + (get_flag() & 3));
+  }
+  uint16_t get_data() const { return data; }
+
   bool operator==(const Move &move) const;
+  bool operator!=(const Move &move) const { return !(*this == move); }
 
   std::string to_uci_notation() const;
+
+private:
+  uint16_t data;
+
+  int get_flag() const { return data >> 12; }
+  bool is_promotion() const { return (get_flag() & PROMOTION_FLAG) != 0; }
+
+  static const int PROMOTION_FLAG = 8;
 };
+
+static_assert(sizeof(Move) == 2);
+static_assert(std::is_trivially_copyable_v<Move>);
+static_assert(std::is_trivially_default_constructible_v<Move>);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <stddef.h>
+
+#include "move.hpp"
+
+// no legal chess position has more than 218 moves,
+// so 256 leaves room for the pseudo-legal moves as well
+const int MAX_MOVES = 256;
+
+// A list of moves stored inline, so that generating moves at a node
+// doesn't need any heap allocations
+class MoveList {
+public:
+  MoveList() : nr_moves(0) {}
+
+  void push_back(const Move &move) {
+    assert(nr_moves < MAX_MOVES);
+    moves[nr_moves++] = move;
+  }
+  void clear() { nr_moves = 0; }
+
+  size_t size() const { return nr_moves; }
+  bool empty() const { return nr_moves == 0; }
+
+  Move &operator[](size_t i) { return moves[i]; }
+  const Move &operator[](size_t i) const { return moves[i]; }
+
+  Move *begin() { return moves.data(); }
+  Move *end() { return moves.data() + nr_moves; }
+  const Move *begin() const { return moves.data(); }
+  const Move *end() const { return moves.data() + nr_moves; }
+
+private:
+  std::array<Move, MAX_MOVES> moves;
+  size_t nr_moves;
+};
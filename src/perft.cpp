@@ -1,41 +1,49 @@
 #include "perft.hpp"
 #include "board/board.hpp"
 #include "fmt/core.h"
+#include <chrono>
 
-int perft(Board &board, int depth) {
+template <MakeMode make_mode> int perft(Board &board, int depth) {
   if (depth == 0) {
     return 1;
   }
 
+  MoveList legal_moves;
+  board.get_legal_moves(ALL, legal_moves);
+  // every generated move is legal, so the leaves don't have to be made
+  if (depth == 1) {
+    return legal_moves.size();
+  }
+
+  MoveMaker<make_mode> move_maker(board);
   int nodes = 0;
-  const Color player = board.get_player_to_move();
-  std::vector<Move> pseudo_legal_moves = board.get_pseudo_legal_moves(ALL);
-  for (const Move &move : pseudo_legal_moves) {
-    board.make(move);
-    if (board.is_in_check(player)) {
-      board.undo();
-      continue;
-    }
-    nodes += perft(board, depth - 1);
-    board.undo();
+  for (const Move &move : legal_moves) {
+    move_maker.make(move);
+    nodes += perft<make_mode>(board, depth - 1);
+    move_maker.undo();
   }
   return nodes;
 }
 
+template int perft<MAKE_UNDO>(Board &board, int depth);
+template int perft<COPY_MAKE>(Board &board, int depth);
+
 void divide(Board &board, int depth) {
+  const auto start_time = std::chrono::high_resolution_clock::now();
   int nodes_searched = 0;
-  const Color player = board.get_player_to_move();
-  std::vector<Move> pseudo_legal_moves = board.get_pseudo_legal_moves(ALL);
-  for (const Move &move : pseudo_legal_moves) {
+  MoveList legal_moves;
+  board.get_legal_moves(ALL, legal_moves);
+  for (const Move &move : legal_moves) {
     board.make(move);
-    if (board.is_in_check(player)) {
-      board.undo();
-      continue;
-    }
     const int nodes = perft(board, depth - 1);
     nodes_searched += nodes;
     fmt::println("{}: {}", move.to_uci_notation(), nodes);
     board.undo();
   }
+  const auto elapsed = std::chrono::high_resolution_clock::now() - start_time;
+  const long long time =
+      std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+  const long long nps = nodes_searched * 1000LL / (time == 0 ? 1 : time);
   fmt::println("\nNodes searched: {}", nodes_searched);
+  fmt::println("Time: {} ms ({} nps)", time, nps);
 }
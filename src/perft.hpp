@@ -2,5 +2,5 @@
 
 #include "board/board.hpp"
 
-int perft(Board &board, int depth);
+template <MakeMode make_mode = MAKE_UNDO> int perft(Board &board, int depth);
 void divide(Board &board, int depth);
@@ -1,9 +1,11 @@
 #include "uci.hpp"
 
 #include <algorithm>
+#include <charconv>
 #include <cmath>
 #include <fmt/core.h>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -85,6 +87,38 @@ Command get_go_command(const std::vector<std::string> &words) {
   return Command::go_infinite();
 }
 
+// the whole string has to be a number, unlike with std::stoi,
+// and a malformed value doesn't throw on the input thread
+std::optional<int> parse_int(const std::string &str) {
+  int value;
+  const char *end = str.data() + str.size();
+  const auto [ptr, error] = std::from_chars(str.data(), end, value);
+  if (error != std::errc() || ptr != end) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+Command get_setoption_command(const std::string &input,
+                             const std::vector<std::string> &words) {
+  if (words.size() != 5 || words.at(1) != "name" || words.at(3) != "value") {
+    return Command::invalid(input);
+  }
+
+  std::string name = words.at(2);
+  std::optional<int> value = parse_int(words.at(4));
+  if (!value.has_value()) {
+    return Command::invalid(input);
+  }
+  if (name == "Hash") {
+    return Command::set_hash(value.value());
+  }
+  if (name == "Threads") {
+    return Command::set_threads(value.value());
+  }
+  return Command::invalid(input);
+}
+
 Command process(const std::string &input) {
   const std::vector<std::string> words = str_split(input, ' ');
 
@@ -98,6 +132,10 @@ Command process(const std::string &input) {
     return Command::update_board(fen, moves);
   } else if (words.at(0) == "go") {
     return get_go_command(words);
+  } else if (words.at(0) == "setoption") {
+    return get_setoption_command(input, words);
+  } else if (input == "ucinewgame") {
+    return Command::new_game();
   } else if (input == "quit") {
     return Command::quit();
   } else {
@@ -128,4 +166,47 @@ std::string show(const SearchSummary &ss) {
 std::string bestmove(const Move &move) {
   return fmt::format("bestmove {}\n", move.to_uci_notation());
 }
+
+// a node reaches a stage if the moves from the earlier stages
+// didn't cause a cutoff
+std::string show_stages_reached(
+    const std::array<long, NR_PICKER_STAGES> &stages_reached) {
+  std::array<long, NR_PICKER_STAGES> reached{};
+  long total = 0;
+  for (int stage = NR_PICKER_STAGES - 1; stage >= 0; stage--) {
+    total += stages_reached.at(stage);
+    reached.at(stage) = total;
+  }
+  return fmt::format(
+      "info string stages reached hash {} captures {} killers {} quiets {}",
+      reached.at(HASH_MOVE), reached.at(CAPTURES), reached.at(KILLERS),
+      reached.at(QUIETS));
+}
+
+std::string show_attack_computations(long attack_computations, long nodes) {
+  return fmt::format(
+      "info string attack computations {} per node {:.2f}",
+      attack_computations,
+      (double)attack_computations / (nodes == 0 ? 1 : nodes));
+}
+
+// the better the moves are ordered,
+// the more often the first move is the one that causes the cutoff
+std::string show_cutoffs(long cutoffs, long first_move_cutoffs) {
+  return fmt::format("info string cutoffs {} first move {:.1f}%", cutoffs,
+                     100.0 * first_move_cutoffs / (cutoffs == 0 ? 1 : cutoffs));
+}
+
+// the growth in nodes from the previous depth to this one
+std::string show_branching_factor(long nodes, long previous_nodes) {
+  const long divisor = previous_nodes == 0 ? 1 : previous_nodes;
+  return fmt::format("info string branching factor {:.2f}",
+                     (double)nodes / divisor);
+}
+
+// the number of times the root was searched again with a wider window
+std::string show_aspiration(long fail_highs, long fail_lows) {
+  return fmt::format("info string aspiration fail highs {} fail lows {}",
+                     fail_highs, fail_lows);
+}
 } // namespace uci
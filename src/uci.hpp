@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <string>
 
 #include "engine/command.hpp"
@@ -9,4 +10,10 @@ namespace uci {
 Command process(const std::string &input);
 std::string show(const SearchSummary &search_summary);
 std::string bestmove(const Move &move);
+std::string show_stages_reached(
+    const std::array<long, NR_PICKER_STAGES> &stages_reached);
+std::string show_attack_computations(long attack_computations, long nodes);
+std::string show_cutoffs(long cutoffs, long first_move_cutoffs);
+std::string show_branching_factor(long nodes, long previous_nodes);
+std::string show_aspiration(long fail_highs, long fail_lows);
 }; // namespace uci
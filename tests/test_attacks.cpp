@@ -0,0 +1,85 @@
+#include "board/attacks.hpp"
+#include "defs.hpp"
+#include "fmt/core.h"
+#include <gtest/gtest.h>
+
+// compare the table lookups with the slow ray based generator
+// for a set of pseudo random occupancies on every square
+static void test_slider_attacks() {
+  uint64_t state = 0x9E3779B97F4A7C15;
+  for (int square = 0; square < 64; square++) {
+    for (int i = 0; i < 200; i++) {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      const uint64_t occupied = state & (state >> 3);
+      EXPECT_EQ(attacks::rook(square, occupied),
+                attacks::rook_attacks_slow(square, occupied))
+          << SQUARES.at(square);
+      EXPECT_EQ(attacks::bishop(square, occupied),
+                attacks::bishop_attacks_slow(square, occupied))
+          << SQUARES.at(square);
+    }
+  }
+}
+
+TEST(AttacksTests, MagicLookup) {
+  attacks::init(false);
+  test_slider_attacks();
+  attacks::init(attacks::cpu_supports_pext());
+}
+
+TEST(AttacksTests, PextLookup) {
+  if (!attacks::cpu_supports_pext()) {
+    GTEST_SKIP() << "the CPU doesn't support BMI2";
+  }
+  attacks::init(true);
+  test_slider_attacks();
+}
+
+TEST(AttacksTests, EmptyBoard) {
+  EXPECT_EQ(attacks::rook(a8, 0), 0xFEULL | 0x0101010101010100ULL);
+  EXPECT_EQ(attacks::bishop(h1, 0) & (1ULL << a8), 1ULL << a8);
+  EXPECT_EQ(attacks::queen(d4, 0),
+            attacks::rook(d4, 0) | attacks::bishop(d4, 0));
+}
+
+// the fills of whole sets of sliders must match the lookups piece by piece
+static void test_slider_sets(uint64_t (*sliders)(uint64_t, uint64_t,
+                                                 uint64_t)) {
+  uint64_t state = 0x2545F4914F6CDD1D;
+  auto next = [&state]() {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+  };
+  for (int i = 0; i < 5000; i++) {
+    const uint64_t occupied = next() & next();
+    const uint64_t rooks = occupied & next() & next();
+    const uint64_t bishops = occupied & next() & next();
+    uint64_t expected = 0;
+    for (int square = 0; square < 64; square++) {
+      if ((rooks >> square) & 1) {
+        expected |= attacks::rook(square, occupied);
+      }
+      if ((bishops >> square) & 1) {
+        expected |= attacks::bishop(square, occupied);
+      }
+    }
+    ASSERT_EQ(sliders(rooks, bishops, occupied), expected)
+        << fmt::format("rooks {:#x} bishops {:#x} occupied {:#x}", rooks,
+                       bishops, occupied);
+  }
+}
+
+TEST(AttacksTests, SliderSetsScalar) {
+  test_slider_sets(attacks::sliders_scalar);
+}
+
+TEST(AttacksTests, SliderSetsAvx2) {
+  if (!attacks::cpu_supports_avx2()) {
+    GTEST_SKIP() << "the CPU doesn't support AVX2";
+  }
+  test_slider_sets(attacks::sliders_avx2);
+}
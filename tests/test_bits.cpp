@@ -0,0 +1,35 @@
+#include "board/bits.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(BitsTests, SetBitsIteratesFromLeastSignificant) {
+  std::vector<int> indices;
+  for (const int i : bits::SetBits(0x8000000000010005ULL)) {
+    indices.push_back(i);
+  }
+  EXPECT_EQ(indices, std::vector<int>({0, 2, 16, 63}));
+
+  for (const int i : bits::SetBits(0)) {
+    ADD_FAILURE() << "empty bitboard has set bit " << i;
+  }
+}
+
+TEST(BitsTests, PopLSB) {
+  uint64_t bb = 0x0000000000000A00ULL;
+  EXPECT_EQ(bits::popLSB(bb), 9);
+  EXPECT_EQ(bb, 0x0000000000000800ULL);
+  EXPECT_EQ(bits::popLSB(bb), 11);
+  EXPECT_EQ(bb, 0ULL);
+}
+
+TEST(BitsTests, NrBitsSet) {
+  EXPECT_EQ(bits::nr_bits_set(0), 0);
+  EXPECT_EQ(bits::nr_bits_set(0xFFFFFFFFFFFFFFFFULL), 64);
+  EXPECT_EQ(bits::nr_bits_set(0x8000000000010005ULL), 4);
+}
+
+TEST(BitsTests, Reverse) {
+  EXPECT_EQ(bits::reverse(1), 0x8000000000000000ULL);
+  EXPECT_EQ(bits::reverse(0x00000000000000F0ULL), 0x0F00000000000000ULL);
+  EXPECT_EQ(bits::reverse(0x0123456789ABCDEFULL), 0xF7B3D591E6A2C480ULL);
+}
@@ -1,5 +1,7 @@
 #include "board/board.hpp"
+#include "evaluation/evaluation.hpp"
 #include "fen.hpp"
+#include "fmt/core.h"
 #include <gtest/gtest.h>
 
 TEST(Board, get_doubled_pawns) {
@@ -16,3 +18,236 @@ TEST(Board, get_doubled_pawns) {
   EXPECT_EQ(b.get_doubled_pawns(WHITE), 1);
   EXPECT_EQ(b.get_doubled_pawns(BLACK), 1);
 }
+
+// the hash and the piece lookup must stay in sync with the bitboards,
+// which are compared by setting up each position from its FEN
+static void test_position_after_moves(std::string_view fen,
+                                      const std::vector<Move> &moves,
+                                      const std::vector<std::string> &fens) {
+  Board b = fen::get_position(fen);
+  for (size_t i = 0; i < moves.size(); i++) {
+    b.make(moves.at(i));
+    const Board expected = fen::get_position(fens.at(i));
+    EXPECT_EQ(b.get_hash(), expected.get_hash())
+        << fmt::format("hash differs from {}", fens.at(i));
+    EXPECT_EQ(b.to_string(), expected.to_string())
+        << fmt::format("pieces differ from {}", fens.at(i));
+  }
+  for (size_t i = 0; i < moves.size(); i++) {
+    b.undo();
+  }
+  const Board initial = fen::get_position(fen);
+  EXPECT_EQ(b.get_hash(), initial.get_hash());
+  EXPECT_EQ(b.to_string(), initial.to_string());
+}
+
+TEST(Board, hash_castling_and_captures) {
+  test_position_after_moves(
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      {Move(e1, g1, CASTLING), Move(a6, e2), Move(c3, e2)},
+      {
+          "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R4RK1 b kq - 1 1",
+          "r3k2r/p1ppqpb1/1n2pnp1/3PN3/1p2P3/2N2Q1p/PPPBbPPP/R4RK1 w kq - 0 2",
+          "r3k2r/p1ppqpb1/1n2pnp1/3PN3/1p2P3/5Q1p/PPPBNPPP/R4RK1 b kq - 0 2",
+      });
+}
+
+TEST(Board, hash_castling_rights_lost_by_captured_rooks) {
+  test_position_after_moves("r3k2r/8/8/8/8/8/6b1/R3K2R b KQkq - 0 1",
+                            {Move(g2, h1), Move(a1, a8)},
+                            {
+                                "r3k2r/8/8/8/8/8/8/R3K2b w Qkq - 0 2",
+                                "R3k2r/8/8/8/8/8/8/4K2b b k - 0 2",
+                            });
+}
+
+TEST(Board, hash_en_passant_and_promotion) {
+  test_position_after_moves(
+      "4k3/8/8/8/1p6/8/P7/4K3 w - - 0 1",
+      {Move(a2, a4, PAWN_TWO_SQUARES_FORWARD), Move(b4, a3, EN_PASSANT)},
+      {
+          "4k3/8/8/8/Pp6/8/8/4K3 b - a3 0 1",
+          "4k3/8/8/8/8/p7/8/4K3 w - - 0 2",
+      });
+  test_position_after_moves("4k3/1P6/8/8/8/8/8/4K3 w - - 0 1",
+                            {Move(b7, b8, QUEEN)},
+                            {"1Q2k3/8/8/8/8/8/8/4K3 b - - 0 1"});
+}
+
+TEST(Board, hash_transposition) {
+  Board board1 = Board::get_starting_position();
+  board1.make(Move(g1, f3));
+  board1.make(Move(g8, f6));
+  board1.make(Move(b1, c3));
+
+  Board board2 = Board::get_starting_position();
+  board2.make(Move(b1, c3));
+  board2.make(Move(g8, f6));
+  board2.make(Move(g1, f3));
+
+  EXPECT_EQ(board1.get_hash(), board2.get_hash());
+  EXPECT_NE(board1.get_hash(), Board::get_starting_position().get_hash());
+}
+
+TEST(Board, get_piece_type_after_moves) {
+  test_position_after_moves(
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      {Move(e1, g1, CASTLING), Move(a6, e2), Move(c3, e2),
+       Move(e8, c8, CASTLING)},
+      {
+          "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R4RK1 b kq - 1 1",
+          "r3k2r/p1ppqpb1/1n2pnp1/3PN3/1p2P3/2N2Q1p/PPPBbPPP/R4RK1 w kq - 0 2",
+          "r3k2r/p1ppqpb1/1n2pnp1/3PN3/1p2P3/5Q1p/PPPBNPPP/R4RK1 b kq - 0 2",
+          "2kr3r/p1ppqpb1/1n2pnp1/3PN3/1p2P3/5Q1p/PPPBNPPP/R4RK1 w - - 1 3",
+      });
+  test_position_after_moves(
+      "4k3/1P6/8/8/1p6/8/P7/4K3 w - - 0 1",
+      {Move(a2, a4, PAWN_TWO_SQUARES_FORWARD), Move(b4, a3, EN_PASSANT),
+       Move(b7, b8, KNIGHT)},
+      {
+          "4k3/1P6/8/8/Pp6/8/8/4K3 b - a3 0 1",
+          "4k3/1P6/8/8/8/p7/8/4K3 w - - 0 2",
+          "1N2k3/8/8/8/8/p7/8/4K3 b - - 0 2",
+      });
+}
+
+TEST(Board, copy_keeps_history) {
+  Board board = Board::get_starting_position();
+  const std::vector<Move> moves = {Move(g1, f3), Move(g8, f6), Move(f3, g1),
+                                   Move(f6, g8), Move(g1, f3), Move(g8, f6),
+                                   Move(f3, g1)};
+  for (const Move &move : moves) {
+    board.make(move);
+  }
+
+  // the repetition can only be seen with the history of the game
+  Board copy = board;
+  EXPECT_EQ(copy.get_ply(), moves.size());
+  EXPECT_EQ(copy.get_hash(), board.get_hash());
+  EXPECT_TRUE(copy.is_threefold_repetition());
+
+  for (size_t i = 0; i < moves.size(); i++) {
+    copy.undo();
+  }
+  EXPECT_EQ(copy.get_ply(), 0);
+  EXPECT_EQ(copy.get_hash(), Board::get_starting_position().get_hash());
+  EXPECT_EQ(copy.to_string(), Board::get_starting_position().to_string());
+  EXPECT_EQ(board.get_ply(), moves.size());
+}
+
+TEST(Board, make_copy_matches_make) {
+  const std::vector<std::string> fens = {
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      "4k3/1P6/8/8/Pp6/8/8/4K3 b - a3 0 1",
+  };
+  for (const std::string &fen : fens) {
+    Board board = fen::get_position(fen);
+    const BoardSnapshot parent = board.get_snapshot();
+    for (const Move &move : board.get_legal_moves(ALL)) {
+      Board copy_made = board;
+      copy_made.make(board.make_copy(move));
+      board.make(move);
+      EXPECT_EQ(copy_made.get_hash(), board.get_hash());
+      EXPECT_EQ(copy_made.to_string(), board.to_string());
+      EXPECT_EQ(copy_made.get_material(WHITE), board.get_material(WHITE));
+      EXPECT_EQ(copy_made.get_psqt(BLACK), board.get_psqt(BLACK));
+      board.undo();
+
+      copy_made.undo(parent);
+      EXPECT_EQ(copy_made.get_hash(), board.get_hash());
+      EXPECT_EQ(copy_made.to_string(), board.to_string());
+    }
+  }
+}
+
+TEST(Board, check_info_after_make_and_undo) {
+  // the knight on d2 is pinned to the king by the queen on a5
+  Board board = fen::get_position("4k3/8/8/q7/8/8/3N4/4K3 w - - 0 1");
+  EXPECT_EQ(board.get_checkers(), 0);
+  EXPECT_EQ(board.get_pinned(), MASKS.squares.at(d2));
+  EXPECT_EQ(board.get_occupied(),
+            MASKS.squares.at(e8) | MASKS.squares.at(a5) |
+                MASKS.squares.at(d2) | MASKS.squares.at(e1));
+
+  board.make(Move(e1, f1));
+  board.make(Move(a5, b5));
+  EXPECT_EQ(board.get_checkers(), MASKS.squares.at(b5));
+  EXPECT_EQ(board.get_pinned(), 0);
+  EXPECT_TRUE(board.is_in_check(WHITE));
+  EXPECT_EQ(board.get_occupied(),
+            MASKS.squares.at(e8) | MASKS.squares.at(b5) |
+                MASKS.squares.at(d2) | MASKS.squares.at(f1));
+
+  board.undo();
+  board.undo();
+  EXPECT_EQ(board.get_checkers(), 0);
+  EXPECT_EQ(board.get_pinned(), MASKS.squares.at(d2));
+  EXPECT_FALSE(board.is_in_check(WHITE));
+}
+
+TEST(Board, see) {
+  // the pawn on e5 is undefended
+  Board board =
+      fen::get_position("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1");
+  EXPECT_EQ(board.see(Move(e1, e5)), PAWN_VALUE);
+
+  // the knight wins a pawn but is recaptured,
+  // and recapturing with the rook would lose even more
+  board = fen::get_position(
+      "1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1");
+  EXPECT_EQ(board.see(Move(d3, e5)), PAWN_VALUE - KNIGHT_VALUE);
+
+  // an undefended piece is won outright
+  board = fen::get_position("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1");
+  EXPECT_EQ(board.see(Move(d2, d5)), QUEEN_VALUE);
+
+  // the rook behind the queen recaptures the rook that took the queen
+  board = fen::get_position("4k3/3r4/8/3p4/8/8/3Q4/3RK3 w - - 0 1");
+  EXPECT_EQ(board.see(Move(d2, d5)), PAWN_VALUE - QUEEN_VALUE + ROOK_VALUE);
+
+  // a quiet move to a square where the piece is captured
+  board = fen::get_position("4k3/8/2p5/8/8/8/8/1R2K3 w - - 0 1");
+  EXPECT_EQ(board.see(Move(b1, b5)), -ROOK_VALUE);
+}
+
+TEST(Board, make_null) {
+  // the en passant square is gone once the move is passed
+  Board board = fen::get_position("4k3/8/8/8/Pp6/8/8/4K3 b - a3 0 1");
+  const uint64_t hash = board.get_hash();
+  board.make_null();
+  EXPECT_EQ(board.get_player_to_move(), WHITE);
+  EXPECT_EQ(board.get_en_passant_square(), std::nullopt);
+  EXPECT_EQ(board.get_hash(),
+            fen::get_position("4k3/8/8/8/Pp6/8/8/4K3 w - - 0 2").get_hash());
+  EXPECT_TRUE(board.last_move_was_null());
+  EXPECT_EQ(board.get_legal_moves(ALL).size(),
+            fen::get_position("4k3/8/8/8/Pp6/8/8/4K3 w - - 0 2")
+                .get_legal_moves(ALL)
+                .size());
+
+  board.make(Move(e1, d2));
+  EXPECT_FALSE(board.last_move_was_null());
+  board.undo();
+  board.undo_null();
+  EXPECT_EQ(board.get_player_to_move(), BLACK);
+  EXPECT_EQ(board.get_en_passant_square(), a3);
+  EXPECT_EQ(board.get_hash(), hash);
+  EXPECT_FALSE(board.last_move_was_null());
+}
+
+TEST(Board, make_null_resets_check_info) {
+  // the black knight on e7 is pinned to its king by the rook on e1
+  Board board = fen::get_position("4k3/4n3/8/8/8/8/8/4R1K1 w - - 0 1");
+  EXPECT_EQ(board.get_pinned(), 0);
+  board.make_null();
+  EXPECT_EQ(board.get_pinned(), MASKS.squares.at(e7));
+  EXPECT_EQ(board.get_checkers(), 0);
+  board.undo_null();
+  EXPECT_EQ(board.get_pinned(), 0);
+}
+
+TEST(Board, has_non_pawn_material) {
+  Board board = fen::get_position("4k3/pp6/8/8/8/8/6PP/4K1N1 w - - 0 1");
+  EXPECT_TRUE(board.has_non_pawn_material(WHITE));
+  EXPECT_FALSE(board.has_non_pawn_material(BLACK));
+}
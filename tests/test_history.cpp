@@ -0,0 +1,36 @@
+#include "engine/history.hpp"
+#include "move.hpp"
+#include <gtest/gtest.h>
+
+TEST(History, update) {
+  History history;
+  const Move move(g1, f3);
+  EXPECT_EQ(history.get(WHITE, move), 0);
+
+  history.update(WHITE, move, History::bonus(4));
+  EXPECT_EQ(history.get(WHITE, move), 16);
+  EXPECT_EQ(history.get(BLACK, move), 0);
+
+  history.update(WHITE, move, -History::bonus(2));
+  EXPECT_EQ(history.get(WHITE, move), 12);
+
+  history.clear();
+  EXPECT_EQ(history.get(WHITE, move), 0);
+}
+
+TEST(History, update_stays_within_limits) {
+  History history;
+  const Move move(e2, e4, PAWN_TWO_SQUARES_FORWARD);
+  int previous = 0;
+  for (int i = 0; i < 1000; i++) {
+    // the score approaches the limit without passing it
+    history.update(BLACK, move, History::bonus(60));
+    EXPECT_GE(history.get(BLACK, move), previous);
+    EXPECT_LE(history.get(BLACK, move), MAX_HISTORY);
+    previous = history.get(BLACK, move);
+  }
+  for (int i = 0; i < 1000; i++) {
+    history.update(BLACK, move, -MAX_HISTORY * 2);
+    EXPECT_GE(history.get(BLACK, move), -MAX_HISTORY);
+  }
+}
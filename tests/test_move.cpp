@@ -901,3 +901,28 @@ TEST(MoveTests, PromotionCaptureMoveTest) {
   EXPECT_EQ(board.get_material(WHITE), white_material);
   EXPECT_EQ(board.get_psqt(WHITE), white_psqt);
 }
+
+TEST(MoveTests, PackedMoveFieldsTest) {
+  Move normal(g1, f3);
+  EXPECT_EQ(normal.get_start(), g1);
+  EXPECT_EQ(normal.get_end(), f3);
+  EXPECT_EQ(normal.get_move_type(), NORMAL);
+  EXPECT_FALSE(normal.get_promotion_piece().has_value());
+
+  Move castling(e8, c8, CASTLING);
+  EXPECT_EQ(castling.get_move_type(), CASTLING);
+  Move en_passant(d5, e6, EN_PASSANT);
+  EXPECT_EQ(en_passant.get_move_type(), EN_PASSANT);
+  Move pawn_two(h2, h4, PAWN_TWO_SQUARES_FORWARD);
+  EXPECT_EQ(pawn_two.get_move_type(), PAWN_TWO_SQUARES_FORWARD);
+
+  for (PieceType piece : {KNIGHT, BISHOP, ROOK, QUEEN}) {
+    Move promotion(a2, b1, piece);
+    EXPECT_EQ(promotion.get_start(), a2);
+    EXPECT_EQ(promotion.get_end(), b1);
+    EXPECT_EQ(promotion.get_move_type(), PROMOTION);
+    EXPECT_EQ(promotion.get_promotion_piece(), piece);
+    EXPECT_EQ(Move::from_data(promotion.get_data()), promotion);
+  }
+  EXPECT_EQ(Move(a2, b1, KNIGHT).to_uci_notation(), "a2b1n");
+}
@@ -803,3 +803,124 @@ TEST(MoveGenTests, Position156) {
   std::vector<int> expected = {9, 193, 1676, 38751, 346695};
   test_fen(fen, expected);
 }
+
+// the legal moves must be exactly the pseudo-legal moves
+// that don't leave the player's king in check
+static void test_legal_moves(Board &board, int depth,
+                             MoveCategory move_category) {
+  const Color player = board.get_player_to_move();
+  std::vector<std::string> expected_moves;
+  for (const Move &move : board.get_pseudo_legal_moves(move_category)) {
+    board.make(move);
+    if (!board.is_in_check(player)) {
+      expected_moves.push_back(move.to_uci_notation());
+    }
+    board.undo();
+  }
+  std::vector<std::string> actual_moves;
+  for (const Move &move : board.get_legal_moves(move_category)) {
+    actual_moves.push_back(move.to_uci_notation());
+  }
+  std::sort(expected_moves.begin(), expected_moves.end());
+  std::sort(actual_moves.begin(), actual_moves.end());
+  ASSERT_EQ(actual_moves, expected_moves) << board.to_string();
+
+  if (depth > 1) {
+    for (const Move &move : board.get_legal_moves(ALL)) {
+      board.make(move);
+      test_legal_moves(board, depth - 1, move_category);
+      board.undo();
+    }
+  }
+}
+
+TEST(MoveGenTests, LegalMovesMatchFilteredPseudoLegalMoves) {
+  const std::vector<std::string> fens = {
+      STARTING_POSITION_FEN,
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      // en passant that would uncover a rook attack along the rank
+      "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+      "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+      "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+      // double check and en passant out of check
+      "4k3/8/8/2Pp4/8/8/8/3RK2b w - d6 0 1",
+      "8/8/8/8/k2Pp2Q/8/8/3K4 b - d3 0 1",
+  };
+  for (const std::string &fen : fens) {
+    Board board = fen::get_position(fen);
+    test_legal_moves(board, 3, ALL);
+    test_legal_moves(board, 3, TACTICAL);
+  }
+}
+
+TEST(MoveGenTests, CopyMakeMatchesMakeUndo) {
+  const std::vector<std::string> fens = {
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+      "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+  };
+  for (const std::string &fen : fens) {
+    Board b = fen::get_position(fen);
+    EXPECT_EQ(perft<COPY_MAKE>(b, 3), perft<MAKE_UNDO>(b, 3))
+        << fmt::format("FEN: {}", fen);
+  }
+}
+
+static bool contains(const MoveList &moves, const Move &move) {
+  return std::find(moves.begin(), moves.end(), move) != moves.end();
+}
+
+// gives_check, is_pseudo_legal and is_legal must agree with the generator,
+// also for the moves of the two positions before, which are like the hash
+// and killer moves that come from elsewhere in the tree
+static void test_move_primitives(Board &board, int depth,
+                                 const MoveList &parent_moves,
+                                 const MoveList &grandparent_moves) {
+  const MoveList pseudo_legal_moves = board.get_pseudo_legal_moves(ALL);
+  const MoveList legal_moves = board.get_legal_moves(ALL);
+  for (const MoveList *moves :
+       {&pseudo_legal_moves, &parent_moves, &grandparent_moves}) {
+    for (const Move &move : *moves) {
+      const bool pseudo_legal = contains(pseudo_legal_moves, move);
+      ASSERT_EQ(board.is_pseudo_legal(move), pseudo_legal)
+          << move.to_uci_notation() << "\n" << board.to_string();
+      if (pseudo_legal) {
+        ASSERT_EQ(board.is_legal(move), contains(legal_moves, move))
+            << move.to_uci_notation() << "\n" << board.to_string();
+      }
+    }
+  }
+
+  for (const Move &move : legal_moves) {
+    const bool gives_check = board.gives_check(move);
+    board.make(move);
+    const bool in_check = board.is_in_check(board.get_player_to_move());
+    if (depth > 1) {
+      test_move_primitives(board, depth - 1, pseudo_legal_moves,
+                           parent_moves);
+    }
+    board.undo();
+    ASSERT_EQ(gives_check, in_check)
+        << move.to_uci_notation() << "\n" << board.to_string();
+  }
+}
+
+TEST(MoveGenTests, MovePrimitivesMatchGenerator) {
+  const std::vector<std::string> fens = {
+      STARTING_POSITION_FEN,
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+      "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+      "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+      "4k3/8/8/2Pp4/8/8/8/3RK2b w - d6 0 1",
+      "8/8/8/8/k2Pp2Q/8/8/3K4 b - d3 0 1",
+      // discovered checks by castling, en passant and promotions
+      "4k3/8/8/8/8/8/8/R3K2R w KQ - 0 1",
+      "8/8/8/RPp4k/8/8/8/K7 w - c6 0 1",
+      "1n6/R1P4k/8/8/8/8/8/4K3 w - - 0 1",
+  };
+  for (const std::string &fen : fens) {
+    Board board = fen::get_position(fen);
+    test_move_primitives(board, 3, MoveList(), MoveList());
+  }
+}
@@ -0,0 +1,170 @@
+#include "board/board.hpp"
+#include "defs.hpp"
+#include "engine/move_picker.hpp"
+#include "fen.hpp"
+#include "move.hpp"
+#include <gtest/gtest.h>
+
+static std::vector<Move> pick_all(MovePicker &move_picker,
+                                  std::vector<PickerStage> &stages) {
+  std::vector<Move> moves;
+  for (std::optional<Move> move = move_picker.next(); move.has_value();
+       move = move_picker.next()) {
+    moves.push_back(move.value());
+    stages.push_back(move_picker.get_stage());
+  }
+  return moves;
+}
+
+TEST(MovePickerTests, PicksEveryLegalMoveOnce) {
+  Board board = fen::get_position(
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+  const Move hash_move(e1, g1, CASTLING);
+  const Move killer_move(a2, a3);
+  const Move second_killer_move(g2, g3);
+  const History history;
+  MovePicker move_picker(board, hash_move, {killer_move, second_killer_move},
+                         history);
+  std::vector<PickerStage> stages;
+  std::vector<Move> moves = pick_all(move_picker, stages);
+
+  const MoveList legal_moves = board.get_legal_moves(ALL);
+  ASSERT_EQ(moves.size(), legal_moves.size());
+  for (const Move &move : legal_moves) {
+    EXPECT_EQ(std::count(moves.begin(), moves.end(), move), 1)
+        << move.to_uci_notation();
+  }
+
+  EXPECT_EQ(moves.at(0), hash_move);
+  EXPECT_EQ(stages.at(0), HASH_MOVE);
+  EXPECT_EQ(stages.at(1), CAPTURES);
+  const size_t killer_index =
+      std::find(moves.begin(), moves.end(), killer_move) - moves.begin();
+  EXPECT_EQ(stages.at(killer_index), KILLERS);
+  // the queen taking the knight defended by the bishop loses the most
+  EXPECT_EQ(stages.at(killer_index - 1), CAPTURES);
+  EXPECT_EQ(moves.at(killer_index - 1), Move(f3, f6));
+  EXPECT_EQ(moves.at(killer_index + 1), second_killer_move);
+  EXPECT_EQ(stages.at(killer_index + 1), KILLERS);
+  EXPECT_EQ(stages.at(killer_index + 2), QUIETS);
+  EXPECT_TRUE(std::is_sorted(stages.begin(), stages.end()));
+}
+
+TEST(MovePickerTests, SkipsIllegalHashAndKillerMoves) {
+  Board board = fen::get_position(
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+  // moves from another position with the same hash or at the same ply,
+  // where the second killer move is a capture in this position
+  const History history;
+  MovePicker move_picker(board, Move(e1, e2), {Move(b1, c3), Move(e5, f7)},
+                         history);
+  std::vector<PickerStage> stages;
+  std::vector<Move> moves = pick_all(move_picker, stages);
+
+  EXPECT_EQ(moves.size(), board.get_legal_moves(ALL).size());
+  EXPECT_EQ(std::count(stages.begin(), stages.end(), HASH_MOVE), 0);
+  EXPECT_EQ(std::count(stages.begin(), stages.end(), KILLERS), 0);
+}
+
+// every legal move is picked once, whatever the moves passed to the picker
+static void expect_every_legal_move_once(const Board &board,
+                                         MovePicker &move_picker) {
+  std::vector<PickerStage> stages;
+  const std::vector<Move> moves = pick_all(move_picker, stages);
+  const MoveList legal_moves = board.get_legal_moves(ALL);
+  ASSERT_EQ(moves.size(), legal_moves.size());
+  for (const Move &move : legal_moves) {
+    EXPECT_EQ(std::count_if(moves.begin(), moves.end(),
+                            [&](const Move &picked) {
+                              return picked.get_data() == move.get_data();
+                            }),
+              1)
+        << move.to_uci_notation();
+  }
+}
+
+TEST(MovePickerTests, HashMoveOfAnotherTypeDoesNotHideMove) {
+  // the squares of a double pawn push and of castling,
+  // from positions where another piece made a normal move
+  const History history;
+  Board board = Board::get_starting_position();
+  MovePicker pawn_move_picker(board, Move(e2, e4), {}, history);
+  expect_every_legal_move_once(board, pawn_move_picker);
+
+  board = fen::get_position("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+  MovePicker castling_picker(board, Move(e1, g1), {}, history);
+  expect_every_legal_move_once(board, castling_picker);
+}
+
+TEST(MovePickerTests, KillerMovesOfAnotherTypeDoNotHideMoves) {
+  const History history;
+  Board board = Board::get_starting_position();
+  MovePicker pawn_move_picker(board, std::nullopt,
+                              {Move(e2, e4), Move(d2, d4)}, history);
+  expect_every_legal_move_once(board, pawn_move_picker);
+
+  // the legal killer move is still only picked once
+  board = fen::get_position("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+  MovePicker castling_picker(board, std::nullopt,
+                             {Move(a1, b1), Move(e1, g1)}, history);
+  expect_every_legal_move_once(board, castling_picker);
+}
+
+TEST(MovePickerTests, OrdersQuietsByHistory) {
+  Board board = fen::get_position(
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+  History history;
+  history.update(WHITE, Move(a2, a4, PAWN_TWO_SQUARES_FORWARD), 400);
+  history.update(WHITE, Move(d2, g5), 200);
+  history.update(WHITE, Move(e1, d1), -100);
+  // the same move by the other player has its own score
+  history.update(BLACK, Move(g2, g3), 800);
+  MovePicker move_picker(board, std::nullopt, {}, history);
+  std::vector<PickerStage> stages;
+  std::vector<Move> moves = pick_all(move_picker, stages);
+
+  const size_t first_quiet =
+      std::find(stages.begin(), stages.end(), QUIETS) - stages.begin();
+  EXPECT_EQ(moves.at(first_quiet), Move(a2, a4, PAWN_TWO_SQUARES_FORWARD));
+  EXPECT_EQ(moves.at(first_quiet + 1), Move(d2, g5));
+  EXPECT_EQ(moves.back(), Move(e1, d1));
+}
+
+static size_t count_non_losing_tactical_moves(const Board &board) {
+  const MoveList tactical_moves = board.get_legal_moves(TACTICAL);
+  return std::count_if(tactical_moves.begin(), tactical_moves.end(),
+                       [&](const Move &move) { return board.see(move) >= 0; });
+}
+
+TEST(MovePickerTests, OnlyTacticalMoves) {
+  Board board = fen::get_position(
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+  // a quiet hash move is not picked when only picking tactical moves
+  MovePicker quiet_hash_move_picker(board, Move(a2, a3));
+  std::vector<PickerStage> stages;
+  std::vector<Move> moves = pick_all(quiet_hash_move_picker, stages);
+  EXPECT_EQ(moves.size(), count_non_losing_tactical_moves(board));
+  EXPECT_EQ(std::count(stages.begin(), stages.end(), CAPTURES), moves.size());
+
+  MovePicker capture_hash_move_picker(board, Move(d5, e6));
+  stages.clear();
+  moves = pick_all(capture_hash_move_picker, stages);
+  EXPECT_EQ(moves.size(), count_non_losing_tactical_moves(board));
+  EXPECT_EQ(moves.at(0), Move(d5, e6));
+  EXPECT_EQ(stages.at(0), HASH_MOVE);
+}
+
+TEST(MovePickerTests, OnlyTacticalSkipsLosingCaptures) {
+  Board board = fen::get_position(
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+  // the queen taking the pawn defended by the rook loses the queen
+  EXPECT_LT(board.see(Move(f3, h3)), 0);
+  MovePicker move_picker(board, Move(f3, h3));
+  std::vector<PickerStage> stages;
+  std::vector<Move> moves = pick_all(move_picker, stages);
+  EXPECT_EQ(std::count(moves.begin(), moves.end(), Move(f3, h3)), 0);
+  EXPECT_GT(moves.size(), 0);
+  for (const Move &move : moves) {
+    EXPECT_GE(board.see(move), 0) << move.to_uci_notation();
+  }
+}
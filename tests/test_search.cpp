@@ -0,0 +1,37 @@
+#include "board/board.hpp"
+#include "engine/search.hpp"
+#include "engine/search_defs.hpp"
+#include "engine/transposition_table.hpp"
+#include "fen.hpp"
+#include <gtest/gtest.h>
+
+// the move the search reports as its best move after the given depth
+static std::string search_best_move(std::string_view fen, int depth) {
+  Board board = fen::get_position(fen);
+  SearchParams params;
+  params.depth = depth;
+  params.search_mode = DEPTH;
+  std::atomic<bool> stop = false;
+  TranspositionTable tt(1);
+  std::vector<NodeCounter> node_counters(1);
+  Search search(board, params, stop, tt, node_counters, 0);
+
+  testing::internal::CaptureStdout();
+  search.iterative_deepening_search();
+  const std::string output = testing::internal::GetCapturedStdout();
+  const std::string prefix = "bestmove ";
+  const size_t start = output.rfind(prefix);
+  if (start == std::string::npos) {
+    return "";
+  }
+  const size_t move_start = start + prefix.size();
+  return output.substr(move_start, output.find('\n', move_start) - move_start);
+}
+
+TEST(Search, FindsQuietMateAfterManyMoves) {
+  // the mating rook move is generated after all the pawn moves
+  const std::string fen = "k7/8/1K6/8/8/8/PPPPPP2/7R w - - 0 1";
+  for (int depth = 1; depth <= 4; depth++) {
+    EXPECT_EQ(search_best_move(fen, depth), "h1h8") << "depth " << depth;
+  }
+}
@@ -0,0 +1,86 @@
+#include "defs.hpp"
+#include "engine/transposition_table.hpp"
+#include "move.hpp"
+#include <gtest/gtest.h>
+
+TEST(TranspositionTableTests, StoreAndProbe) {
+  TranspositionTable tt(1);
+  const uint64_t key = 0x123456789ABCDEF0;
+  EXPECT_FALSE(tt.probe(key).has_value());
+
+  tt.store(key, 5, -120, UPPER_BOUND, Move(e2, e4, PAWN_TWO_SQUARES_FORWARD));
+  std::optional<TTEntry> entry = tt.probe(key);
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(entry.value().depth, 5);
+  EXPECT_EQ(entry.value().score, -120);
+  EXPECT_EQ(entry.value().bound, UPPER_BOUND);
+  ASSERT_TRUE(entry.value().get_move().has_value());
+  EXPECT_EQ(entry.value().get_move().value().get_move_type(),
+            PAWN_TWO_SQUARES_FORWARD);
+  EXPECT_EQ(entry.value().get_move().value(), Move(e2, e4));
+
+  tt.clear();
+  EXPECT_FALSE(tt.probe(key).has_value());
+}
+
+TEST(TranspositionTableTests, KeepsMoveWhenStoringWithoutOne) {
+  TranspositionTable tt(1);
+  const uint64_t key = 42;
+  tt.store(key, 3, 10, LOWER_BOUND, Move(b7, a8, KNIGHT));
+  tt.store(key, 4, 15, UPPER_BOUND, std::nullopt);
+
+  std::optional<TTEntry> entry = tt.probe(key);
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(entry.value().depth, 4);
+  ASSERT_TRUE(entry.value().get_move().has_value());
+  EXPECT_EQ(entry.value().get_move().value(), Move(b7, a8, KNIGHT));
+  EXPECT_FALSE(entry.value().get_move().value() == Move(b7, a8, QUEEN));
+}
+
+TEST(TranspositionTableTests, BucketKeepsSeveralPositions) {
+  TranspositionTable tt(1);
+  // keys that differ only in their high bits share a bucket
+  const std::vector<uint64_t> keys = {
+      (uint64_t)1 << 60 | 7,
+      (uint64_t)2 << 60 | 7,
+      (uint64_t)3 << 60 | 7,
+      (uint64_t)4 << 60 | 7,
+  };
+  for (size_t i = 0; i < keys.size(); i++) {
+    tt.store(keys.at(i), (int)i + 1, (int)i, EXACT, std::nullopt);
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    std::optional<TTEntry> entry = tt.probe(keys.at(i));
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry.value().score, (int)i);
+  }
+}
+
+TEST(TranspositionTableTests, ShallowStoreKeepsDeepEntry) {
+  TranspositionTable tt(1);
+  const uint64_t key = 99;
+  tt.store(key, 8, 40, LOWER_BOUND, Move(g1, f3));
+
+  // a quiescence result for the same position
+  tt.store(key, 0, 10, UPPER_BOUND, Move(d1, d7));
+  std::optional<TTEntry> entry = tt.probe(key);
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(entry.value().depth, 8);
+  EXPECT_EQ(entry.value().bound, LOWER_BOUND);
+  EXPECT_EQ(entry.value().get_move().value(), Move(g1, f3));
+
+  // slightly shallower or exact results replace it
+  tt.store(key, 6, 20, UPPER_BOUND, std::nullopt);
+  EXPECT_EQ(tt.probe(key).value().depth, 6);
+  tt.store(key, 0, 30, EXACT, std::nullopt);
+  EXPECT_EQ(tt.probe(key).value().score, 30);
+}
+
+TEST(TranspositionTableTests, ShallowStoreReplacesOldSearch) {
+  TranspositionTable tt(1);
+  const uint64_t key = 99;
+  tt.store(key, 8, 40, LOWER_BOUND, Move(g1, f3));
+  tt.new_search();
+  tt.store(key, 0, 10, UPPER_BOUND, std::nullopt);
+  EXPECT_EQ(tt.probe(key).value().depth, 0);
+}
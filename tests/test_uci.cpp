@@ -0,0 +1,29 @@
+#include "engine/command.hpp"
+#include "uci.hpp"
+#include <gtest/gtest.h>
+
+TEST(Uci, setoption) {
+  Command command = uci::process("setoption name Threads value 4");
+  EXPECT_EQ(command.type, SetThreads);
+  EXPECT_EQ(command.arg.integer, 4);
+
+  command = uci::process("setoption name Hash value 64");
+  EXPECT_EQ(command.type, SetHash);
+  EXPECT_EQ(command.arg.integer, 64);
+
+  // malformed values are invalid input instead of ending the engine
+  for (const std::string input :
+       {"setoption name Threads value x", "setoption name Hash value 12mb",
+        "setoption name Threads value 99999999999"}) {
+    command = uci::process(input);
+    EXPECT_EQ(command.type, Invalid) << input;
+    free(command.arg.str);
+  }
+}
+
+TEST(Uci, search_commands) {
+  EXPECT_TRUE(uci::process("go depth 5").is_search());
+  EXPECT_TRUE(uci::process("go infinite").is_search());
+  EXPECT_FALSE(uci::process("go perft 3").is_search());
+  EXPECT_FALSE(uci::process("isready").is_search());
+}
@@ -1,8 +1,15 @@
+#include "test_attacks.cpp"
+#include "test_bits.cpp"
 #include "test_board.cpp"
 #include "test_draw.cpp"
 #include "test_gen_pseudo_legal_moves.cpp"
+#include "test_history.cpp"
 #include "test_move.cpp"
 #include "test_move_gen.cpp"
+#include "test_move_picker.cpp"
+#include "test_search.cpp"
+#include "test_transposition_table.cpp"
+#include "test_uci.cpp"
 #include <gtest/gtest.h>
 
 int main(int argc, char **argv) {